@@ -0,0 +1,369 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// On-target benchmark of the core primitives of libhal-armcortex.
+//
+// Each benchmark runs a number of iterations and records its cost in cycles
+// within a hal::cortex_m::cycle_record. Once complete, the records are copied
+// into the `benchmark_results` table in RAM, `benchmark_complete()` is called
+// to give a debugger a place to break and read the table, and if the ITM's
+// stimulus port 0 is enabled, the table is also written to it as CSV.
+//
+// Costs include the cost of reading the cycle count, which is reported as
+// the `measurement_overhead` entry.
+//
+// The context switch benchmark runs last on the cores that support it, as
+// thread mode never returns to main() once context switching has started. Its
+// results are published by the task that ran it.
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <libhal-armcortex/context_switch.hpp>
+#include <libhal-armcortex/cycle_probe.hpp>
+#include <libhal-armcortex/dwt_counter.hpp>
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-armcortex/itm.hpp>
+#include <libhal-armcortex/startup.hpp>
+#include <libhal-armcortex/system_control.hpp>
+#include <libhal-armcortex/systick_timer.hpp>
+
+using namespace std::chrono_literals;
+
+/// Format version of the benchmark_results table, incremented whenever the
+/// layout of benchmark_result changes.
+constexpr std::uint32_t benchmark_results_version = 1;
+
+/// A single row of the benchmark results table
+struct benchmark_result
+{
+  /// Name of the benchmark
+  char const* name;
+  /// Number of iterations measured
+  std::uint32_t count;
+  /// Shortest iteration in cycles
+  std::uint32_t min;
+  /// Longest iteration in cycles
+  std::uint32_t max;
+  /// Mean iteration in cycles, rounded down
+  std::uint32_t mean;
+};
+
+/// Table read by a debugger, valid once `benchmark_result_count` is non-zero
+extern "C"
+{
+  std::uint32_t volatile benchmark_result_version = benchmark_results_version;
+  std::uint32_t volatile benchmark_result_count = 0;
+  std::array<benchmark_result, hal::cortex_m::cycle_probe_capacity>
+    benchmark_results{};
+
+  [[gnu::noinline, gnu::used]] void benchmark_complete()
+  {
+    asm volatile("" : : : "memory");
+  }
+}
+
+namespace {
+// ARMv6-M and ARMv8-M baseline do not have the DWT cycle counter, so SysTick,
+// free running from the processor clock, is used as the time base instead.
+// They also lack the ITM, so results are only published to the debugger, and
+// the PendSV context switch is only implemented for the other cores.
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+constexpr bool has_cycle_counter = false;
+constexpr bool has_itm = false;
+constexpr bool has_context_switch = false;
+#else
+constexpr bool has_cycle_counter = true;
+constexpr bool has_itm = true;
+constexpr bool has_context_switch = true;
+#endif
+
+struct systick_registers_t
+{
+  std::uint32_t volatile control;
+  std::uint32_t volatile reload;
+  std::uint32_t volatile current;
+  std::uint32_t const volatile calibration;
+};
+
+inline auto* systick =
+  reinterpret_cast<systick_registers_t*>(0xE000'E010UL);  // NOLINT
+
+/// SysTick's counter is 24 bits wide
+constexpr std::uint32_t systick_counter_mask = 0x00FF'FFFF;
+
+/// Enable SysTick, clocked by the processor, without its interrupt
+constexpr std::uint32_t systick_free_running = 0b101;
+
+/// Number of iterations of each benchmark
+constexpr std::uint32_t iterations = 64;
+
+/// IRQ used to measure interrupt entry and exit
+constexpr hal::cortex_m::irq_t benchmark_irq = 0;
+
+/// Number of IRQs within the vector table of the benchmark
+constexpr hal::cortex_m::irq_t benchmark_irq_count = 8;
+
+std::uint32_t cycles()
+{
+  if constexpr (has_cycle_counter) {
+    return *hal::cortex_m::cycle_count_register;
+  } else {
+    return systick->current;
+  }
+}
+
+std::uint32_t elapsed(std::uint32_t p_start, std::uint32_t p_end)
+{
+  if constexpr (has_cycle_counter) {
+    return p_end - p_start;
+  } else {
+    // SysTick counts down
+    return (p_start - p_end) & systick_counter_mask;
+  }
+}
+
+template<typename Operation>
+void measure(char const* p_name, Operation&& p_operation)
+{
+  auto& record = hal::cortex_m::allocate_cycle_record(p_name);
+  for (std::uint32_t i = 0; i < iterations; i++) {
+    auto const start = cycles();
+    p_operation();
+    record.add(elapsed(start, cycles()));
+  }
+}
+
+std::uint32_t volatile handler_entry = 0;
+std::uint32_t volatile handler_exit = 0;
+
+void benchmark_handler()
+{
+  handler_entry = cycles();
+  handler_exit = cycles();
+}
+
+void empty_handler()
+{
+}
+
+/// Measure from the software trigger to the first instruction of the handler,
+/// and from the last instruction of the handler back to thread mode.
+void measure_interrupt_latency(char const* p_entry_name,
+                               char const* p_exit_name)
+{
+  auto& entry = hal::cortex_m::allocate_cycle_record(p_entry_name);
+  auto& exit = hal::cortex_m::allocate_cycle_record(p_exit_name);
+  for (std::uint32_t i = 0; i < iterations; i++) {
+    auto const start = cycles();
+    hal::cortex_m::trigger_interrupt(benchmark_irq);
+    hal::cortex_m::instruction_synchronization_barrier();
+    auto const end = cycles();
+    entry.add(elapsed(start, handler_entry));
+    exit.add(elapsed(handler_exit, end));
+  }
+}
+
+void benchmark_interrupts()
+{
+  hal::cortex_m::initialize_interrupts<benchmark_irq_count>();
+
+  measure("enable_interrupt", [] {
+    hal::cortex_m::enable_interrupt(benchmark_irq, empty_handler);
+  });
+  measure("verify_vector_enabled", [] {
+    auto const enabled =
+      hal::cortex_m::verify_vector_enabled(benchmark_irq, empty_handler);
+    asm volatile("" : : "r"(enabled));
+  });
+  measure("critical_section", [] { hal::cortex_m::critical_section lock; });
+  measure("critical_section(threshold)",
+          [] { hal::cortex_m::critical_section lock(0x80); });
+
+  hal::cortex_m::enable_interrupt(benchmark_irq, benchmark_handler);
+  measure_interrupt_latency("irq_entry", "irq_exit");
+
+  // Same measurement through the shared irq callback dispatcher
+  hal::cortex_m::disable_interrupt(benchmark_irq);
+  hal::cortex_m::initialize_irq_dispatch<benchmark_irq_count, 1>();
+  hal::cortex_m::attach_interrupt(benchmark_irq, benchmark_handler);
+  measure_interrupt_latency("irq_entry_dispatched", "irq_exit_dispatched");
+  hal::cortex_m::detach_interrupts(benchmark_irq);
+}
+
+void benchmark_timers()
+{
+  // The time base of devices without a cycle counter is SysTick, which cannot
+  // also be used by the systick_timer, and these devices do not have a DWT.
+  if constexpr (has_cycle_counter) {
+    hal::cortex_m::dwt_counter counter(1'000'000.0f);
+    measure("dwt_counter::uptime", [&counter] {
+      auto const uptime = counter.uptime();
+      asm volatile("" : : "r"(uptime));
+    });
+
+    hal::cortex_m::systick_timer timer(1'000'000.0f);
+    measure("systick_timer::schedule",
+            [&timer] { timer.schedule([] {}, 10ms); });
+    timer.cancel();
+  }
+}
+
+void benchmark_startup()
+{
+  // Copies the same amount of data as a 1 KiB .data section at startup
+  static constexpr std::array<std::uint32_t, 256> rom{};
+  static std::array<std::uint32_t, 256> ram{};
+
+  measure("copy_section(1KiB)", [] {
+    hal::cortex_m::copy_section({
+      .start = ram.data(),
+      .source = rom.data(),
+      .size = sizeof(ram),
+    });
+  });
+}
+
+std::array<hal::cortex_m::task_context, 2> tasks{};
+hal::cortex_m::cycle_record* context_switch_record = nullptr;
+std::uint32_t volatile switch_start = 0;
+
+hal::cortex_m::task_context& select_next_task(
+  hal::cortex_m::task_context* p_current)
+{
+  return (p_current == &tasks[0]) ? tasks[1] : tasks[0];
+}
+
+void publish_results();
+
+/// Yields to the pong task on each iteration, then publishes every result
+void ping_task(void*)
+{
+  for (std::uint32_t i = 0; i < iterations; i++) {
+    switch_start = cycles();
+    hal::cortex_m::request_context_switch();
+  }
+
+  publish_results();
+
+  while (true) {
+    continue;
+  }
+}
+
+/// Records the cost of each switch from the ping task, then yields back
+void pong_task(void*)
+{
+  while (true) {
+    context_switch_record->add(elapsed(switch_start, cycles()));
+    hal::cortex_m::request_context_switch();
+  }
+}
+
+/// Measure a yield from one task to another, from the request in the
+/// yielding task to the first instruction of the task switched in.
+[[noreturn]] void benchmark_context_switch()
+{
+  alignas(8) static std::array<std::uint32_t, 256> ping_stack{};
+  alignas(8) static std::array<std::uint32_t, 256> pong_stack{};
+
+  context_switch_record =
+    &hal::cortex_m::allocate_cycle_record("context_switch");
+  hal::cortex_m::initialize_task(tasks[0], ping_stack, ping_task, nullptr);
+  hal::cortex_m::initialize_task(tasks[1], pong_stack, pong_task, nullptr);
+  hal::cortex_m::initialize_context_switching(select_next_task);
+  hal::cortex_m::start_context_switching();
+}
+
+void write_text(hal::serial& p_serial, std::string_view p_text)
+{
+  p_serial.write(std::span(reinterpret_cast<hal::byte const*>(p_text.data()),
+                           p_text.size()));
+}
+
+void write_number(hal::serial& p_serial, std::uint32_t p_value)
+{
+  std::array<char, 12> buffer{};
+  auto const result =
+    std::to_chars(buffer.data(), buffer.data() + buffer.size(), p_value);
+  write_text(p_serial, std::string_view(buffer.data(), result.ptr));
+}
+
+void publish_results()
+{
+  auto const records = hal::cortex_m::cycle_records();
+  for (std::size_t i = 0; i < records.size(); i++) {
+    auto const& record = records[i];
+    benchmark_results[i] = {
+      .name = record.name,
+      .count = record.count,
+      .min = record.min,
+      .max = record.max,
+      .mean = static_cast<std::uint32_t>(record.sum / record.count),
+    };
+  }
+  benchmark_result_count = records.size();
+  benchmark_complete();
+
+  if constexpr (has_itm) {
+    if (not hal::cortex_m::itm_port_enabled(0)) {
+      return;
+    }
+
+    hal::cortex_m::itm_serial itm(0);
+    write_text(itm, "name,count,min,max,mean\n");
+    for (auto const& result : std::span(benchmark_results)
+                                .first(benchmark_result_count)) {
+      write_text(itm, result.name);
+      for (auto const value :
+           { result.count, result.min, result.max, result.mean }) {
+        write_text(itm, ",");
+        write_number(itm, value);
+      }
+      write_text(itm, "\n");
+    }
+  }
+}
+}  // namespace
+
+int main()
+{
+  if constexpr (has_cycle_counter) {
+    // Enables DWT's cycle counter
+    hal::cortex_m::dwt_counter enable_cycle_counter(1'000'000.0f);
+  } else {
+    systick->reload = systick_counter_mask;
+    systick->current = 0;
+    systick->control = systick_free_running;
+  }
+
+  measure("measurement_overhead", [] {});
+  benchmark_interrupts();
+  benchmark_timers();
+  benchmark_startup();
+
+  if constexpr (has_context_switch) {
+    benchmark_context_switch();
+  }
+
+  publish_results();
+
+  while (true) {
+    continue;
+  }
+}
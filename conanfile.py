@@ -71,5 +71,6 @@ class libhal_arm_cortex_conan(ConanFile):
             self.cpp_info.exelinkflags.append("-L" + linker_path)
 
     def package_id(self):
+        # The C++ runtime hooks of exceptions.cpp are only compiled without
+        # libhal-exceptions, so the option changes the binary.
         del self.info.options.use_picolibc
-        del self.info.options.use_libhal_exceptions
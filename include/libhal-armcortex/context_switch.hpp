@@ -0,0 +1,143 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libhal/functional.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief Saved state of a task that is not running
+ *
+ * The registers of a task are saved on its own stack, so its context is only
+ * the stack pointer at the point it was switched out.
+ */
+struct task_context
+{
+  /// Stack pointer of the task, after its registers have been saved
+  std::uint32_t* stack_pointer = nullptr;
+  /// Lowest address the task's stack pointer may reach, loaded into PSPLIM on
+  /// ARMv8-M when the task is switched in. nullptr disables the check.
+  std::uint32_t const* stack_limit = nullptr;
+};
+
+/// Words of the stack used by start_context_switching() until the first task
+/// is switched in. Holds an extended exception frame, its alignment padding
+/// and the registers, including floating point registers, saved by the
+/// context switch handler.
+inline constexpr std::size_t bootstrap_stack_words = 26 + 1 + 9 + 16;
+
+/**
+ * @brief Selects the task to run next
+ *
+ * Called by the PendSV handler, with interrupts masked, on each context
+ * switch. The argument is the task being switched out, or nullptr for the
+ * first switch made by `start_context_switching()`. Return the same task to
+ * keep running it.
+ */
+using task_selector = hal::callback<task_context&(task_context* p_current)>;
+
+/**
+ * @brief Prepare a task to be switched in for the first time
+ *
+ * Places an initial exception frame at the top of the stack, such that the
+ * first switch to the task calls `p_entry(p_argument)` in thread mode on the
+ * process stack. Tasks must not return, a task that returns loops forever.
+ *
+ * @param p_task - context to initialize
+ * @param p_stack - stack of the task. Must outlive the task and be large
+ * enough for the deepest call chain of the task, plus 52 words to hold its
+ * registers, including floating point registers, while it is switched out.
+ * On ARMv8-M, the stack limit is set such that an overflow raises a
+ * UsageFault while room remains to save the task's registers.
+ * @param p_entry - function run by the task
+ * @param p_argument - argument passed to p_entry
+ * @throws hal::argument_out_of_domain - if the stack is too small to hold the
+ * initial frame.
+ */
+void initialize_task(task_context& p_task,
+                     std::span<std::uint32_t> p_stack,
+                     void (*p_entry)(void* p_argument),
+                     void* p_argument);
+
+/**
+ * @brief Install the PendSV context switch handler
+ *
+ * Tasks run in thread mode on the process stack (PSP) while exceptions keep
+ * running on the main stack (MSP), so each task stack only needs room for the
+ * task itself. The PendSV handler saves r4-r11 of the outgoing task on its
+ * stack, along with s16-s31 on devices with an FPU when the task has used
+ * floating point. Lazy stacking of s0-s15 is left to the hardware. The
+ * selector then picks the next task and its registers are restored.
+ *
+ * Only one user of PendSV can exist at a time, so this cannot be combined
+ * with `initialize_deferred_work()`. Deferred work can instead be run by a
+ * task.
+ *
+ * Time slicing is done by calling `request_context_switch()` periodically,
+ * for example from a systick_timer or timer_queue callback:
+ *
+ *     hal::cortex_m::initialize_context_switching(round_robin);
+ *     hal::cortex_m::timer_event time_slice([&]() {
+ *       hal::cortex_m::request_context_switch();
+ *       queue.schedule(time_slice, 10ms);
+ *     });
+ *     queue.schedule(time_slice, 10ms);
+ *     hal::cortex_m::start_context_switching();
+ *
+ * PRECONDITION: Interrupt vector table must be initialized before calling this
+ * function.
+ *
+ * @param p_select_next - called on every switch to select the next task
+ * @param p_priority - priority of the PendSV exception. Must remain the lowest
+ * priority of the system, such that a switch never occurs while another
+ * exception is active.
+ * @throws hal::operation_not_permitted - if the interrupt vector table has not
+ * been initialized.
+ * @throws hal::operation_not_supported - on devices other than ARMv7-M and
+ * ARMv8-M mainline.
+ */
+void initialize_context_switching(task_selector p_select_next,
+                                  std::uint8_t p_priority = 0xFF);
+
+/**
+ * @brief Switch thread mode to the process stack and run the first task
+ *
+ * The code that calls this never resumes. Its stack continues to be used by
+ * exceptions.
+ *
+ * PRECONDITION: `initialize_context_switching()` has been called.
+ */
+[[noreturn]] void start_context_switching();
+
+/**
+ * @brief Pend a context switch
+ *
+ * The switch happens once every active exception has returned. Safe to call
+ * from any context. A task can call this to yield to the next task.
+ */
+void request_context_switch();
+
+/**
+ * @brief Get the running task
+ *
+ * @return task_context* - the running task or nullptr if context switching has
+ * not started.
+ */
+task_context* current_task();
+}  // namespace hal::cortex_m
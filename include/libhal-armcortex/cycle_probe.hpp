@@ -0,0 +1,184 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace hal::cortex_m {
+/**
+ * @brief Accumulated cycle measurements of a single cycle_probe site
+ *
+ */
+struct cycle_record
+{
+  /// Number of histogram buckets, one for each possible bit width of a 32-bit
+  /// cycle count.
+  static constexpr std::size_t histogram_buckets = 33;
+
+  /**
+   * @brief Add a measurement to the record
+   *
+   * @param p_cycles - number of cycles measured
+   */
+  void add(std::uint32_t p_cycles)
+  {
+    count++;
+    sum += p_cycles;
+    min = std::min(min, p_cycles);
+    max = std::max(max, p_cycles);
+    histogram[std::bit_width(p_cycles)]++;
+  }
+
+  /// Name of the site
+  char const* name = nullptr;
+  /// Number of measurements
+  std::uint32_t count = 0;
+  /// Shortest measurement in cycles
+  std::uint32_t min = std::numeric_limits<std::uint32_t>::max();
+  /// Longest measurement in cycles
+  std::uint32_t max = 0;
+  /// Sum of all measurements in cycles, divide by count for the mean
+  std::uint64_t sum = 0;
+  /// Log2 histogram of measurements. Bucket 0 counts measurements of 0 cycles
+  /// and bucket N counts measurements in the range [2^(N-1), 2^N).
+  std::array<std::uint32_t, histogram_buckets> histogram{};
+};
+
+/// Maximum number of distinct cycle_probe sites in an application
+inline constexpr std::size_t cycle_probe_capacity = 16;
+
+/// Address of the DWT cycle count register (CYCCNT)
+inline constexpr std::uintptr_t cycle_count_address = 0xE000'1004UL;
+
+/// Register read by cycle_probe, this can be redirected by unit tests
+inline auto* cycle_count_register =
+  reinterpret_cast<std::uint32_t volatile*>(cycle_count_address);
+
+/**
+ * @brief Claim a record from the statically allocated record table
+ *
+ * Used by cycle_probe to allocate a record for each site. Once every record is
+ * in use, a scratch record that is not part of `cycle_records()` is returned.
+ *
+ * @param p_name - name of the site
+ * @return cycle_record& - the claimed record
+ */
+cycle_record& allocate_cycle_record(char const* p_name);
+
+/**
+ * @brief Get the records of every cycle_probe site that has run
+ *
+ * @return std::span<cycle_record const> - the records in the order that the
+ * sites first ran.
+ */
+[[nodiscard]] std::span<cycle_record const> cycle_records();
+
+/**
+ * @brief Clear the measurements of every record
+ *
+ * Sites keep their records.
+ */
+void reset_cycle_records();
+
+/**
+ * @brief Name of a cycle_probe site, usable as a template parameter
+ *
+ * @tparam length - length of the name including the null terminator
+ */
+template<std::size_t length>
+struct cycle_probe_name
+{
+  consteval cycle_probe_name(char const (&p_name)[length])  // NOLINT
+  {
+    std::copy_n(p_name, length, value);
+  }
+
+  char value[length]{};
+};
+
+/**
+ * @brief Measures the cycles spent within a scope
+ *
+ * This driver is supported for Cortex M3 devices and above.
+ *
+ * Reads CYCCNT at construction and destruction and adds the difference to the
+ * record of the site. Each distinct name gets its own statically allocated
+ * record. No heap is used and no virtual functions are called per sample,
+ * which keeps the overhead of the probe to a handful of cycles. Measurements
+ * must be shorter than 2^32 cycles.
+ *
+ * The cycle counter must be enabled by constructing a dwt_counter or
+ * dwt_profiler before using a probe. Records are not protected against
+ * concurrent access, thus a single site must not be entered from both thread
+ * code and an interrupt.
+ *
+ * Example usage:
+ *
+ *     void dma_isr() {
+ *       hal::cortex_m::cycle_probe<"dma_isr"> probe;
+ *       // ...
+ *     }
+ *
+ *     for (auto const& record : hal::cortex_m::cycle_records()) {
+ *       std::array<char, 64> line{};
+ *       auto length = snprintf(line.data(), line.size(), "%s: %lu %lu\n",
+ *                              record.name, record.min, record.max);
+ *       serial.write(hal::as_bytes(line).first(length));
+ *     }
+ *
+ * @tparam name - name of the site
+ */
+template<cycle_probe_name name>
+class cycle_probe
+{
+public:
+  cycle_probe()
+    : m_start(*cycle_count_register)
+  {
+  }
+
+  cycle_probe(cycle_probe const&) = delete;
+  cycle_probe& operator=(cycle_probe const&) = delete;
+  cycle_probe(cycle_probe&&) = delete;
+  cycle_probe& operator=(cycle_probe&&) = delete;
+
+  ~cycle_probe()
+  {
+    // Unsigned subtraction handles a single wrap of the counter
+    std::uint32_t const cycles = *cycle_count_register - m_start;
+    record().add(cycles);
+  }
+
+  /**
+   * @brief Get the record of this site
+   *
+   * @return cycle_record& - the record of this site
+   */
+  static cycle_record& record()
+  {
+    static cycle_record& site_record = allocate_cycle_record(name.value);
+    return site_record;
+  }
+
+private:
+  std::uint32_t m_start;
+};
+}  // namespace hal::cortex_m
@@ -0,0 +1,134 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libhal/functional.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief A function and the context it is called with
+ *
+ */
+struct deferred_call
+{
+  /// Function to call, must not be null
+  void (*function)(void* p_context) = nullptr;
+  /// Context passed to the function
+  void* context = nullptr;
+};
+
+/**
+ * @brief Storage for a single entry of the deferred work queue
+ *
+ * Only the deferred work queue should access the contents of this type.
+ */
+struct deferred_work_slot
+{
+  /// Position of the queue at which this slot is next written or read
+  std::atomic<std::uint32_t> sequence = 0;
+  /// Call stored within this slot
+  deferred_call call{};
+};
+
+/**
+ * @brief Initialize the deferred work queue
+ *
+ * Deferred work runs interrupt "bottom halves" outside of the interrupt that
+ * produced them. Interrupt service routines push a call onto the queue with
+ * `defer()` and return, and the PendSV handler, running at the lowest
+ * priority, calls each of them in order once no other interrupt is active.
+ * This keeps the time spent in each interrupt to a minimum and coalesces the
+ * processing of bursts of interrupts into a single exception.
+ *
+ * The queue is a bounded multi-producer, single-consumer ring. `defer()` is
+ * lock-free on ARMv7-M and ARMv8-M mainline, and briefly masks interrupts on
+ * other devices. Calls are made in the order they were deferred.
+ *
+ * Takes ownership of PendSV, so this cannot be combined with
+ * `initialize_context_switching()`.
+ *
+ * PRECONDITION: Interrupt vector table must be initialized before calling this
+ * function.
+ *
+ * @param p_storage - storage for the queue. Its size must be a power of two
+ * and determines the number of calls that can be waiting at once. The storage
+ * must outlive the use of `defer()`.
+ * @param p_priority - priority of the PendSV exception. Should remain the
+ * lowest priority of the system, such that deferred work never preempts an
+ * interrupt.
+ * @throws hal::operation_not_permitted - if the interrupt vector table has not
+ * been initialized.
+ * @throws hal::argument_out_of_domain - if the size of the storage is not a
+ * power of two.
+ */
+void initialize_deferred_work(std::span<deferred_work_slot> p_storage,
+                              std::uint8_t p_priority = 0xFF);
+
+/**
+ * @brief Initialize the deferred work queue with statically allocated storage
+ *
+ * @tparam capacity - number of calls that can be waiting at once. Must be a
+ * power of two.
+ * @param p_priority - priority of the PendSV exception
+ */
+template<std::size_t capacity>
+void initialize_deferred_work(std::uint8_t p_priority = 0xFF)
+{
+  static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+                "Deferred work capacity must be a power of two.");
+  static std::array<deferred_work_slot, capacity> storage{};
+  initialize_deferred_work(storage, p_priority);
+}
+
+/**
+ * @brief Defer a call to the PendSV handler
+ *
+ * Safe to call from any interrupt and from thread mode. Pends PendSV, which
+ * runs the call once every other active interrupt has returned.
+ *
+ * @param p_function - function to call
+ * @param p_context - context passed to the function
+ * @return true - if the call was queued
+ * @return false - if the queue is full or has not been initialized, in which
+ * case the call is dropped and counted by `deferred_work_dropped()`.
+ */
+bool defer(void (*p_function)(void*), void* p_context);
+
+/**
+ * @brief Defer a call of a callback to the PendSV handler
+ *
+ * The callback is referenced by the queue and not copied, so it must outlive
+ * the call. This allows a driver to store its bottom half callback once and
+ * defer it repeatedly without copying it within the interrupt.
+ *
+ * @param p_callback - callback to call
+ * @return true - if the call was queued
+ * @return false - if the queue is full or has not been initialized
+ */
+bool defer(hal::callback<void(void)>& p_callback);
+
+/**
+ * @brief Get the number of calls dropped because the queue was full
+ *
+ * @return std::uint32_t - number of dropped calls since initialization
+ */
+std::uint32_t deferred_work_dropped();
+}  // namespace hal::cortex_m
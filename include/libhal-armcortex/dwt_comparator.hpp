@@ -0,0 +1,172 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hal::cortex_m {
+/**
+ * @brief The type of data access that triggers a watchpoint
+ *
+ */
+enum class dwt_access : std::uint8_t
+{
+  /// Trigger on reads of the watched address range
+  read = 0b0101,
+  /// Trigger on writes to the watched address range
+  write = 0b0110,
+  /// Trigger on reads and writes of the watched address range
+  read_write = 0b0111,
+};
+
+/**
+ * @brief Get the number of comparators implemented by the DWT
+ *
+ * @return std::uint8_t - number of comparators, usually 4 on Cortex M3/M4/M7
+ * devices and 0 if the core does not implement any.
+ */
+[[nodiscard]] std::uint8_t dwt_comparator_count();
+
+/**
+ * @brief A DWT comparator configured as a data address watchpoint
+ *
+ * This driver is supported for ARMv7-M devices (Cortex M3, M4 & M7).
+ *
+ * The comparator watches the address range in hardware, thus watched code runs
+ * at full speed. When the range is accessed, a debug event occurs. With a
+ * debugger attached, the debugger halts the core. Without one, the
+ * DebugMonitor exception is raised, which can be handled by registering a
+ * handler with `enable_interrupt(irq::debug_monitor, handler)`. This makes it
+ * possible to catch buffer overruns in the field by watching the word past
+ * the end of a buffer:
+ *
+ *     hal::cortex_m::dwt_watchpoint guard(buffer.data() + buffer.size(), 4,
+ *                                         hal::cortex_m::dwt_access::write);
+ *
+ * A comparator is allocated on construction and released on destruction.
+ * Comparators are allocated from the highest index down, leaving comparator 0,
+ * the only comparator capable of cycle matching, free for as long as possible.
+ */
+class dwt_watchpoint
+{
+public:
+  /**
+   * @brief Allocate a comparator and watch an address range
+   *
+   * @param p_address - start address of the range to watch. Must be aligned
+   * to p_size.
+   * @param p_size - number of bytes to watch. Must be a power of 2 and no
+   * larger than the comparator's mask supports, which is implementation
+   * defined and at least 32KiB on most devices.
+   * @param p_access - the type of access that triggers the watchpoint
+   * @throws hal::argument_out_of_domain - if the address or size are not
+   * supported by the comparator.
+   * @throws hal::device_or_resource_busy - if every comparator is in use.
+   */
+  dwt_watchpoint(void const volatile* p_address,
+                 std::size_t p_size,
+                 dwt_access p_access);
+
+  dwt_watchpoint(dwt_watchpoint const&) = delete;
+  dwt_watchpoint& operator=(dwt_watchpoint const&) = delete;
+  dwt_watchpoint(dwt_watchpoint&&) = delete;
+  dwt_watchpoint& operator=(dwt_watchpoint&&) = delete;
+
+  /**
+   * @brief Disable the comparator and release it
+   *
+   */
+  ~dwt_watchpoint();
+
+  /**
+   * @brief Determine if the watchpoint has been triggered
+   *
+   * Reading the status clears it.
+   *
+   * @return true - if the watched range was accessed since the last call
+   */
+  [[nodiscard]] bool triggered();
+
+  /**
+   * @brief Get the index of the comparator used by this watchpoint
+   *
+   * @return std::uint8_t - the comparator index
+   */
+  [[nodiscard]] std::uint8_t comparator() const
+  {
+    return m_comparator;
+  }
+
+private:
+  std::uint8_t m_comparator;
+};
+
+/**
+ * @brief DWT comparator 0 configured to match the cycle counter
+ *
+ * This driver is supported for ARMv7-M devices (Cortex M3, M4 & M7).
+ *
+ * A debug event occurs on the cycle that CYCCNT equals the match value. As
+ * with dwt_watchpoint, this halts the core when a debugger is attached and
+ * raises the DebugMonitor exception otherwise. This is useful for triggering
+ * test events at a cycle exact point in time.
+ *
+ * Only comparator 0 supports cycle matching, thus only one dwt_cycle_match
+ * can exist at a time.
+ */
+class dwt_cycle_match
+{
+public:
+  /**
+   * @brief Allocate comparator 0 and arm it to match the cycle counter
+   *
+   * Enables the cycle counter if it is not already running.
+   *
+   * @param p_cycle - the value of CYCCNT at which the event occurs
+   * @throws hal::operation_not_supported - if the core has no cycle counter or
+   * no comparators.
+   * @throws hal::device_or_resource_busy - if comparator 0 is in use.
+   */
+  explicit dwt_cycle_match(std::uint32_t p_cycle);
+
+  dwt_cycle_match(dwt_cycle_match const&) = delete;
+  dwt_cycle_match& operator=(dwt_cycle_match const&) = delete;
+  dwt_cycle_match(dwt_cycle_match&&) = delete;
+  dwt_cycle_match& operator=(dwt_cycle_match&&) = delete;
+
+  /**
+   * @brief Disable comparator 0 and release it
+   *
+   */
+  ~dwt_cycle_match();
+
+  /**
+   * @brief Re-arm the comparator with a new match value
+   *
+   * @param p_cycle - the value of CYCCNT at which the event occurs
+   */
+  void rearm(std::uint32_t p_cycle);
+
+  /**
+   * @brief Determine if the cycle counter has matched
+   *
+   * Reading the status clears it.
+   *
+   * @return true - if CYCCNT matched since the last call
+   */
+  [[nodiscard]] bool triggered();
+};
+}  // namespace hal::cortex_m
@@ -14,8 +14,12 @@
 
 #pragma once
 
-#include <libhal-util/overflow_counter.hpp>
+#include <atomic>
+#include <cstdint>
+
+#include <libhal-armcortex/frequency_scale.hpp>
 #include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
 
 namespace hal::cortex_m {
 /**
@@ -47,11 +51,104 @@ public:
    */
   void register_cpu_frequency(hertz p_cpu_frequency);
 
+  /**
+   * @brief Get the uptime of the counter in nanoseconds
+   *
+   * Converts with a reciprocal computed by `register_cpu_frequency()`, so no
+   * division is performed.
+   *
+   * @return std::uint64_t - nanoseconds since the counter was started
+   */
+  std::uint64_t uptime_ns();
+
+  /**
+   * @brief Convert a duration to a number of CPU cycles
+   *
+   * Converts with a reciprocal computed by `register_cpu_frequency()`, so no
+   * division is performed.
+   *
+   * @param p_duration - duration to convert. Negative durations return 0.
+   * @return std::uint64_t - number of cycles within the duration
+   */
+  std::uint64_t duration_to_cycles(hal::time_duration p_duration) const;
+
+  /**
+   * @brief Get the number of CPU cycles since the counter was started
+   *
+   * Same as `uptime()` but inline and without going through the steady_clock
+   * interface. This is safe to call from any context, including interrupts
+   * that preempt another call to now(), and every caller sees a monotonic
+   * timestamp.
+   *
+   * The 32-bit cycle counter is extended with a single word holding the wrap
+   * count and the top 4 bits of the last count. It is updated lock-free with
+   * LDREX/STREX, and the common case, where neither has changed, performs no
+   * store at all. Devices without exclusive access instructions update it
+   * with interrupts masked.
+   *
+   * To detect every wrap of the 32-bit counter, now() or uptime() must be
+   * called at least once every 15/16ths of 2^32 cycles. The result wraps
+   * after 2^60 cycles.
+   *
+   * @return std::uint64_t - number of cycles since the counter was started
+   */
+  std::uint64_t now()
+  {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__) || not defined(__arm__)
+    // The count must be read after the state it is compared against. An
+    // update by an interrupt in between fails the exchange and is retried.
+    auto state = m_state.load(std::memory_order_acquire);
+    while (true) {
+      std::uint32_t const count = *m_cycle_count;
+      auto const next = advance(state, count);
+      if (next == state ||
+          m_state.compare_exchange_weak(state,
+                                        next,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+        return extend(next, count);
+      }
+    }
+#else
+    return now_with_interrupts_masked();
+#endif
+  }
+
 private:
+  /// Number of bits of the last count stored in the state word
+  static constexpr std::uint32_t count_hint_bits = 4;
+  /// Shift from a count to its hint bits
+  static constexpr std::uint32_t count_hint_shift = 32 - count_hint_bits;
+  /// Mask of the hint bits within the state word
+  static constexpr std::uint32_t count_hint_mask = (1U << count_hint_bits) - 1;
+
+  static constexpr std::uint32_t advance(std::uint32_t p_state,
+                                         std::uint32_t p_count)
+  {
+    auto const hint = p_count >> count_hint_shift;
+    auto wraps = p_state >> count_hint_bits;
+    if (hint < (p_state & count_hint_mask)) {
+      wraps++;
+    }
+    return (wraps << count_hint_bits) | hint;
+  }
+
+  static constexpr std::uint64_t extend(std::uint32_t p_state,
+                                        std::uint32_t p_count)
+  {
+    auto const wraps = p_state >> count_hint_bits;
+    return (static_cast<std::uint64_t>(wraps) << 32) | p_count;
+  }
+
+  std::uint64_t now_with_interrupts_masked();
   std::uint64_t driver_uptime() override;
   hal::hertz driver_frequency() override;
 
-  overflow_counter<32> m_uptime{};
+  std::uint32_t volatile const* m_cycle_count = nullptr;
+  std::atomic<std::uint32_t> m_state = 0;
   hertz m_cpu_frequency{ 1'000'000 };
+  frequency_scale m_cycles_to_nanoseconds{};
+  frequency_scale m_nanoseconds_to_cycles{};
 };
 }  // namespace hal::cortex_m
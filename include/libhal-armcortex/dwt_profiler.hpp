@@ -0,0 +1,171 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <libhal-util/overflow_counter.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief Selects which DWT profiling counters are enabled by a dwt_profiler
+ *
+ * The cycle counter is always enabled.
+ */
+struct dwt_profiler_settings
+{
+  /// Count additional cycles of multi-cycle instructions and instruction
+  /// fetch stalls
+  bool cpi = true;
+  /// Count cycles spent in exception entry, exit and overhead
+  bool exception = true;
+  /// Count cycles spent sleeping
+  bool sleep = true;
+  /// Count additional cycles spent on load/store instructions
+  bool lsu = true;
+  /// Count folded instructions (instructions that took zero cycles)
+  bool fold = true;
+};
+
+/**
+ * @brief The values of each DWT profiling counter at a point in time
+ *
+ * Counters that are not enabled read as zero.
+ */
+struct dwt_snapshot
+{
+  /// Processor clock cycles
+  std::uint64_t cycles = 0;
+  /// Additional cycles of multi-cycle instructions and instruction fetch
+  /// stalls
+  std::uint64_t cpi = 0;
+  /// Cycles spent in exception entry, exit and overhead
+  std::uint64_t exception = 0;
+  /// Cycles spent sleeping
+  std::uint64_t sleep = 0;
+  /// Additional cycles spent on load/store instructions
+  std::uint64_t lsu = 0;
+  /// Folded instructions
+  std::uint64_t fold = 0;
+};
+
+/**
+ * @brief Get the number of events between two snapshots
+ *
+ * @param p_end - snapshot taken at the end of the measurement
+ * @param p_start - snapshot taken at the start of the measurement
+ * @return constexpr dwt_snapshot - events counted between the snapshots
+ */
+constexpr dwt_snapshot operator-(dwt_snapshot const& p_end,
+                                 dwt_snapshot const& p_start)
+{
+  return {
+    .cycles = p_end.cycles - p_start.cycles,
+    .cpi = p_end.cpi - p_start.cpi,
+    .exception = p_end.exception - p_start.exception,
+    .sleep = p_end.sleep - p_start.sleep,
+    .lsu = p_end.lsu - p_start.lsu,
+    .fold = p_end.fold - p_start.fold,
+  };
+}
+
+/**
+ * @brief Profiler built on the DWT performance counters
+ *
+ * This driver is supported for Cortex M3 devices and above.
+ *
+ * The DWT provides a 32-bit cycle counter and five 8-bit event counters.
+ * Together they explain where the cycles of a piece of code went: stalled on
+ * memory (cpi & lsu), lost to interrupt overhead (exception) or spent asleep
+ * (sleep). The 8-bit counters are extended to 64-bits in software each time
+ * the counters are sampled. The 8-bit counters will wrap after 256 events,
+ * thus `sample()` must be called at least once every 256 events for the
+ * counts to be exact. Calling `sample()` from a periodic interrupt handler
+ * keeps long measurements exact. Measurements that may have wrapped undetected
+ * will under count the event.
+ *
+ * The cycle counter is not reset, allowing the profiler to be used alongside
+ * a dwt_counter.
+ *
+ * Example usage:
+ *
+ *     hal::cortex_m::dwt_profiler profiler;
+ *     auto const start = profiler.snapshot();
+ *     slow_loop();
+ *     auto const delta = profiler.snapshot() - start;
+ *     // delta.lsu large relative to delta.cycles? The loop is memory bound.
+ *
+ */
+class dwt_profiler
+{
+public:
+  /**
+   * @brief Enable and reset the selected DWT profiling counters
+   *
+   * @param p_settings - counters to enable
+   * @throws hal::operation_not_permitted - if the device does not implement
+   * the DWT profiling counters.
+   */
+  explicit dwt_profiler(dwt_profiler_settings const& p_settings);
+
+  /**
+   * @brief Enable and reset all of the DWT profiling counters
+   *
+   * @throws hal::operation_not_permitted - if the device does not implement
+   * the DWT profiling counters.
+   */
+  dwt_profiler();
+
+  dwt_profiler(dwt_profiler const&) = delete;
+  dwt_profiler& operator=(dwt_profiler const&) = delete;
+  dwt_profiler(dwt_profiler&&) = delete;
+  dwt_profiler& operator=(dwt_profiler&&) = delete;
+
+  /**
+   * @brief Disable the profiling counters enabled by this object
+   *
+   * The cycle counter is left running.
+   */
+  ~dwt_profiler();
+
+  /**
+   * @brief Read every enabled counter
+   *
+   * The counters are read and extended with interrupts masked, so that an
+   * interrupt cannot land between reading two of the counters, nor sample()
+   * the counters between the read and their extension.
+   *
+   * @return dwt_snapshot - the software extended value of each counter
+   */
+  [[nodiscard]] dwt_snapshot snapshot();
+
+  /**
+   * @brief Extend the 8-bit counters without creating a snapshot
+   *
+   * Call this periodically, such as within a timer interrupt, to keep
+   * measurements longer than 256 events exact.
+   */
+  void sample();
+
+private:
+  std::uint32_t m_enabled_counters = 0;
+  overflow_counter<32> m_cycles{};
+  overflow_counter<8> m_cpi{};
+  overflow_counter<8> m_exception{};
+  overflow_counter<8> m_sleep{};
+  overflow_counter<8> m_lsu{};
+  overflow_counter<8> m_fold{};
+};
+}  // namespace hal::cortex_m
@@ -0,0 +1,202 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libhal/units.hpp>
+
+namespace hal::cortex_m {
+/// Bytes the C++ runtime places in front of each exception object. Matches
+/// sizeof(__cxa_refcounted_exception) of GCC's ARM EHABI runtime, which also
+/// holds a __cxa_dependent_exception.
+inline constexpr std::size_t exception_header_size = 128;
+
+/// Largest exception object, in bytes, that can be thrown. The libhal error
+/// types are a fraction of this.
+inline constexpr std::size_t max_exception_object_size = 128;
+
+/// Number of exceptions that can be in flight at once before
+/// initialize_exception_pool() is called. Two allows throwing from a catch
+/// block.
+inline constexpr std::size_t default_exception_pool_size = 2;
+
+/**
+ * @brief Storage for one exception in flight
+ *
+ * Only the exception pool should access the contents of this type.
+ */
+struct exception_pool_block
+{
+  /// Next free block, while the block is free
+  exception_pool_block* next = nullptr;
+  /// Runtime header followed by the exception object
+  alignas(std::max_align_t)
+    std::array<hal::byte,
+               exception_header_size + max_exception_object_size> storage{};
+};
+
+/**
+ * @brief Replace the storage of the exception pool
+ *
+ * On Cortex M, when built without libhal-exceptions (the conan option
+ * `use_libhal_exceptions=False`), this library provides
+ * `__cxa_allocate_exception()` and the other allocation functions of the C++
+ * runtime, which take exceptions from a fixed pool of blocks instead of
+ * calling malloc. Allocating and freeing a block is O(1) with interrupts
+ * masked, so throwing has a bounded cost and never fails due to heap
+ * exhaustion or fragmentation. Throwing with every block in use, or throwing
+ * an object larger than `max_exception_object_size`, calls std::terminate().
+ * With libhal-exceptions, it owns the allocator, and the pool is only used by
+ * direct calls to allocate_exception() and free_exception().
+ *
+ * Until this is called, a built in pool of `default_exception_pool_size`
+ * blocks is used. The pool is sized by the deepest nesting of throws from
+ * catch blocks, plus each `std::exception_ptr` held at once, across every
+ * interrupt that can throw.
+ *
+ * PRECONDITION: No exception is in flight.
+ *
+ * @param p_blocks - storage of the pool, must outlive every exception thrown
+ * @throws hal::argument_out_of_domain - if p_blocks is empty
+ */
+void initialize_exception_pool(std::span<exception_pool_block> p_blocks);
+
+/**
+ * @brief Replace the storage of the exception pool with statically allocated
+ * storage
+ *
+ * @tparam block_count - number of exceptions that can be in flight at once
+ */
+template<std::size_t block_count>
+void initialize_exception_pool()
+{
+  static_assert(block_count > 0, "The exception pool needs at least 1 block.");
+  static std::array<exception_pool_block, block_count> blocks{};
+  initialize_exception_pool(blocks);
+}
+
+/**
+ * @brief Allocate an exception object from the pool
+ *
+ * Used by `__cxa_allocate_exception()`. The runtime header in front of the
+ * object is zeroed.
+ *
+ * @param p_object_size - size of the exception object in bytes
+ * @return void* - the exception object or nullptr if the object is too large
+ * or the pool is exhausted.
+ */
+[[nodiscard]] void* allocate_exception(std::size_t p_object_size);
+
+/**
+ * @brief Allocate a dependent exception, as used by std::rethrow_exception()
+ *
+ * Used by `__cxa_allocate_dependent_exception()`.
+ *
+ * @return void* - zeroed dependent exception or nullptr if the pool is
+ * exhausted.
+ */
+[[nodiscard]] void* allocate_dependent_exception();
+
+/**
+ * @brief Return an exception or dependent exception to the pool
+ *
+ * Does nothing if p_exception was not allocated from the pool.
+ *
+ * @param p_exception - pointer returned by allocate_exception() or
+ * allocate_dependent_exception()
+ */
+void free_exception(void* p_exception);
+
+/**
+ * @brief Get the number of free blocks in the exception pool
+ *
+ * @return std::size_t - number of exceptions that can still be thrown
+ */
+[[nodiscard]] std::size_t exception_pool_available();
+
+/**
+ * @brief An entry of the ARM exception index table (.ARM.exidx)
+ *
+ */
+struct exception_index_entry
+{
+  /// 31-bit offset from this word to the start of the function
+  std::uint32_t function_offset;
+  /// Inline unwind instructions, EXIDX_CANTUNWIND or an offset to the
+  /// function's entry of the exception table (.ARM.extab)
+  std::uint32_t content;
+};
+
+/**
+ * @brief Index an exception index table for faster lookup
+ *
+ * When unwinding, the runtime finds the entry of each function on the call
+ * stack via `__gnu_Unwind_Find_exidx()` followed by a binary search. This
+ * library provides `__gnu_Unwind_Find_exidx()` only when built without
+ * libhal-exceptions, whose unwinder does its own lookup. The
+ * linker already sorts the table by address. This divides the table's address
+ * range into equally sized buckets, each storing the first entry that can
+ * cover it, such that the binary search only covers the entries of one
+ * bucket. Each bucket reduces the search by log2(entries / buckets) steps.
+ *
+ * @param p_table - exception index table sorted by function address
+ * @param p_buckets - storage of the index, must outlive the table's use. At
+ * least 2 buckets are required.
+ * @throws hal::argument_out_of_domain - if p_buckets has less than 2 buckets
+ */
+void initialize_exception_index(std::span<exception_index_entry const> p_table,
+                                std::span<std::uint32_t> p_buckets);
+
+/**
+ * @brief Index the application's exception index table
+ *
+ * Indexes the table between `__exidx_start` and `__exidx_end` supplied by the
+ * linker script. Call this once at startup. Before it is called, the whole
+ * table is searched. Does nothing in host builds.
+ *
+ * @param p_buckets - storage of the index
+ * @throws hal::argument_out_of_domain - if p_buckets has less than 2 buckets
+ */
+void initialize_exception_index(std::span<std::uint32_t> p_buckets);
+
+/**
+ * @brief Index the application's exception index table with statically
+ * allocated storage
+ *
+ * @tparam bucket_count - number of buckets, each costing 4 bytes of RAM
+ */
+template<std::size_t bucket_count = 64>
+void initialize_exception_index()
+{
+  static_assert(bucket_count >= 2, "The exception index needs 2 buckets.");
+  static std::array<std::uint32_t, bucket_count> buckets{};
+  initialize_exception_index(buckets);
+}
+
+/**
+ * @brief Find the entries of the indexed table that may cover an address
+ *
+ * @param p_address - address of an instruction
+ * @return std::span<exception_index_entry const> - entries whose binary
+ * search finds the entry covering the address. The whole table if the index
+ * has not been initialized.
+ */
+[[nodiscard]] std::span<exception_index_entry const> find_exception_index(
+  std::uintptr_t p_address);
+}  // namespace hal::cortex_m
@@ -0,0 +1,119 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace hal::cortex_m {
+/**
+ * @brief Registers pushed by the hardware on exception entry
+ *
+ */
+struct exception_frame
+{
+  std::uint32_t r0 = 0;
+  std::uint32_t r1 = 0;
+  std::uint32_t r2 = 0;
+  std::uint32_t r3 = 0;
+  std::uint32_t r12 = 0;
+  /// Link register of the code that faulted
+  std::uint32_t lr = 0;
+  /// Address of the instruction that faulted, or the next one to execute for
+  /// imprecise faults
+  std::uint32_t pc = 0;
+  std::uint32_t xpsr = 0;
+};
+
+/**
+ * @brief State of the processor captured by fault_capture_handler()
+ *
+ */
+struct fault_record
+{
+  /// Maximum number of return addresses kept in the backtrace
+  static constexpr std::size_t max_backtrace = 8;
+
+  /// Registers stacked on entry to the fault. All zeros if the fault occurred
+  /// while stacking, as the frame cannot be trusted.
+  exception_frame frame{};
+  /// Link register on entry to the fault handler. Determines the stack the
+  /// frame was pushed onto and if the faulting code used floating point.
+  std::uint32_t exc_return = 0;
+  /// Exception number of the fault, 3 for HardFault, 4 for MemManage, 5 for
+  /// BusFault, 6 for UsageFault.
+  std::uint32_t exception_number = 0;
+  /// Configurable Fault Status Register, holding the MemManage, BusFault
+  /// and UsageFault status bits.
+  std::uint32_t cfsr = 0;
+  /// HardFault Status Register
+  std::uint32_t hfsr = 0;
+  /// MemManage Fault Address Register, valid if cfsr bit 7 is set
+  std::uint32_t mmfar = 0;
+  /// BusFault Address Register, valid if cfsr bit 15 is set
+  std::uint32_t bfar = 0;
+  /// Number of valid entries in backtrace
+  std::uint32_t backtrace_depth = 0;
+  /// The faulting pc, followed by lr and the words of the faulting stack that
+  /// look like return addresses into code, from the innermost call outwards.
+  /// The stack is scanned without unwind information, so entries may be stale
+  /// return addresses left on the stack.
+  std::array<std::uint32_t, max_backtrace> backtrace{};
+};
+
+/**
+ * @brief Fault handler that records the fault and resets the system
+ *
+ * Captures the stacked exception frame, EXC_RETURN, the fault status and
+ * address registers and a short backtrace into a fault_record held in the
+ * `.preserve` section, which is not initialized at startup, then resets the
+ * system immediately. After the reset, call take_fault_record() to retrieve
+ * it. This replaces waiting for a watchdog to recover a system from the
+ * default fault handlers, which loop forever.
+ *
+ * The handler runs on the main stack. If the main stack has overflowed, the
+ * fault escalates to a lockup instead.
+ *
+ * Does nothing in host builds.
+ */
+void fault_capture_handler();
+
+/**
+ * @brief Install fault_capture_handler() for each fault exception
+ *
+ * Installs the handler for HardFault, MemManage, BusFault and UsageFault.
+ * MemManage, BusFault and UsageFault escalate to HardFault unless enabled in
+ * the System Handler Control and State Register, which the handler records
+ * either way.
+ *
+ * PRECONDITION: Interrupt vector table must be initialized before calling this
+ * function, otherwise this does nothing.
+ */
+void install_fault_capture();
+
+/**
+ * @brief Retrieve and clear the fault recorded before the last reset
+ *
+ * Call once early in main(). The record is cleared such that it is only
+ * reported once. Records left over from before a power loss contain random
+ * data and are rejected by their checksum.
+ *
+ * @param p_record - filled with the recorded fault, if there is one
+ * @return true - if a fault was recorded before the last reset
+ */
+[[nodiscard]] bool take_fault_record(fault_record& p_record);
+}  // namespace hal::cortex_m
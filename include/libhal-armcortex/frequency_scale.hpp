@@ -0,0 +1,163 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <libhal/units.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief Scales integers by a fixed ratio without dividing
+ *
+ * The ratio is stored as a 32-bit multiplier and a right shift, such that
+ * `scale(x) == (x * multiplier) >> shift`. The shift is chosen to keep 32
+ * significant bits in the multiplier. The product is computed with two 32x32
+ * bit multiplies, avoiding the 64-bit division library call that converting
+ * between clock cycles and time would otherwise need on every call.
+ *
+ * The multiplier is rounded up so that exact ratios, such as 1ms at 48MHz,
+ * convert exactly for small values. Otherwise results are rounded up by less
+ * than 1 part in 2^31, at most 1.7us per hour of uptime, which is far below the
+ * error of any clock source.
+ */
+class frequency_scale
+{
+public:
+  /**
+   * @brief Construct a scale that maps every value to 0
+   *
+   */
+  constexpr frequency_scale() = default;
+
+  /**
+   * @brief Construct a scale from a ratio
+   *
+   * Uses floating point math and should be computed once, when the frequency
+   * is known, rather than for each conversion.
+   *
+   * @param p_ratio - amount to scale values by. Ratios of 0 or less, or NaN,
+   * scale every value to 0. Ratios at or above 2^32 are clamped.
+   * @return constexpr frequency_scale - scale for the ratio
+   */
+  static constexpr frequency_scale from_ratio(double p_ratio)
+  {
+    constexpr double limit = 4294967296.0;
+    constexpr std::uint8_t maximum_shift = 63;
+
+    if (not(p_ratio > 0.0)) {
+      return {};
+    }
+
+    if (p_ratio >= limit) {
+      return { 0xFFFF'FFFF, 0 };
+    }
+
+    std::uint8_t shift = 0;
+    double scaled = p_ratio;
+    while (shift < maximum_shift && scaled * 2.0 < limit) {
+      scaled *= 2.0;
+      shift++;
+    }
+
+    auto multiplier = static_cast<std::uint64_t>(scaled);
+    if (static_cast<double>(multiplier) < scaled) {
+      multiplier++;
+    }
+
+    if (multiplier > 0xFFFF'FFFF) {
+      multiplier = 0xFFFF'FFFF;
+    }
+
+    return { static_cast<std::uint32_t>(multiplier), shift };
+  }
+
+  /**
+   * @brief Construct a scale from clock cycles to nanoseconds
+   *
+   * @param p_frequency - frequency of the clock
+   * @return constexpr frequency_scale - scale from cycles to nanoseconds
+   */
+  static constexpr frequency_scale cycles_to_nanoseconds(hertz p_frequency)
+  {
+    if (not(p_frequency > 0.0f)) {
+      return {};
+    }
+    return from_ratio(1e9 / static_cast<double>(p_frequency));
+  }
+
+  /**
+   * @brief Construct a scale from nanoseconds to clock cycles
+   *
+   * @param p_frequency - frequency of the clock
+   * @return constexpr frequency_scale - scale from nanoseconds to cycles
+   */
+  static constexpr frequency_scale nanoseconds_to_cycles(hertz p_frequency)
+  {
+    return from_ratio(static_cast<double>(p_frequency) / 1e9);
+  }
+
+  /**
+   * @brief Scale a value by the ratio
+   *
+   * Results that do not fit within 64-bits are truncated.
+   *
+   * @param p_value - value to scale
+   * @return constexpr std::uint64_t - p_value multiplied by the ratio
+   */
+  [[nodiscard]] constexpr std::uint64_t scale(std::uint64_t p_value) const
+  {
+    constexpr std::uint64_t low_word = 0xFFFF'FFFF;
+
+    // Form the 96-bit product from two 32x32 bit partial products
+    auto const low = (p_value & low_word) * m_multiplier;
+    auto const high = (p_value >> 32) * m_multiplier;
+    auto const middle = (low >> 32) + (high & low_word);
+    auto const upper = (high >> 32) + (middle >> 32);
+    auto const lower = (middle << 32) | (low & low_word);
+
+    if (m_shift == 0) {
+      return lower;
+    }
+    return (upper << (64 - m_shift)) | (lower >> m_shift);
+  }
+
+  /**
+   * @return constexpr std::uint32_t - the multiplier of the ratio
+   */
+  [[nodiscard]] constexpr std::uint32_t multiplier() const
+  {
+    return m_multiplier;
+  }
+
+  /**
+   * @return constexpr std::uint8_t - the right shift of the ratio
+   */
+  [[nodiscard]] constexpr std::uint8_t shift() const
+  {
+    return m_shift;
+  }
+
+private:
+  constexpr frequency_scale(std::uint32_t p_multiplier, std::uint8_t p_shift)
+    : m_multiplier(p_multiplier)
+    , m_shift(p_shift)
+  {
+  }
+
+  std::uint32_t m_multiplier = 0;
+  std::uint8_t m_shift = 0;
+};
+}  // namespace hal::cortex_m
@@ -0,0 +1,157 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <libhal/units.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief Depth of sleep entered by the processor
+ *
+ * What is powered down in each depth depends on the device. Deep sleep
+ * usually stops the high speed clocks and takes longer to wake from.
+ */
+enum class sleep_depth : std::uint8_t
+{
+  /// The processor clock is stopped
+  sleep = 0,
+  /// The processor requests the system to enter its deep sleep state
+  deep_sleep = 1,
+};
+
+/**
+ * @brief Settings for the idle functions
+ *
+ */
+struct idle_settings
+{
+  /// Deep sleep is entered when the next deadline is further away than this.
+  /// Should cover the time the device takes to wake from deep sleep and
+  /// restore its clocks. By default deep sleep is never selected.
+  hal::time_duration deep_sleep_threshold = hal::time_duration::max();
+  /// Enter sleep again when returning from an interrupt to thread mode, until
+  /// an interrupt disables this. Thread mode is never resumed in between
+  /// interrupts, which removes the cost of returning to and re-entering it on
+  /// every interrupt of a purely interrupt driven application.
+  bool sleep_on_exit = false;
+  /// Make every interrupt that becomes pending, even if disabled, an event
+  /// that wakes `idle_until_event()`. This allows polling of interrupt flags
+  /// with WFE while the interrupt itself stays disabled.
+  bool send_event_on_pending = false;
+};
+
+/**
+ * @brief Time spent asleep and awake measured by the idle functions
+ *
+ */
+struct idle_statistics
+{
+  /// Cycles spent within the sleep instruction of the idle functions, see
+  /// `idle()` and `idle_until_event()` for how interrupt handlers are counted
+  std::uint64_t asleep_cycles = 0;
+  /// Cycles spent between calls to the idle functions
+  std::uint64_t awake_cycles = 0;
+  /// Number of times sleep was entered
+  std::uint32_t sleeps = 0;
+  /// Number of times deep sleep was entered
+  std::uint32_t deep_sleeps = 0;
+
+  /**
+   * @brief Get the fraction of the time spent asleep
+   *
+   * @return float - ratio of time asleep to the total time, between 0 and 1
+   */
+  [[nodiscard]] float sleep_ratio() const
+  {
+    auto const total = asleep_cycles + awake_cycles;
+    if (total == 0) {
+      return 0.0f;
+    }
+    return static_cast<float>(asleep_cycles) / static_cast<float>(total);
+  }
+};
+
+/**
+ * @brief Configure the sleep behavior of the processor
+ *
+ * Also starts the DWT cycle counter, used to measure the idle statistics, and
+ * resets the statistics.
+ *
+ * @param p_settings - the idle settings
+ */
+void configure_idle(idle_settings const& p_settings);
+
+/**
+ * @brief Select the depth of sleep for the time until the next deadline
+ *
+ * @param p_until_deadline - time until the system must next be awake, such as
+ * `timer_queue::time_until_next()`.
+ * @return sleep_depth - deep sleep if the deadline is further away than the
+ * configured deep sleep threshold, otherwise sleep.
+ */
+[[nodiscard]] sleep_depth select_sleep_depth(
+  hal::time_duration p_until_deadline);
+
+/**
+ * @brief Sleep until the next interrupt
+ *
+ * Selects the depth of sleep then executes WFI. When sleep on exit is
+ * enabled, this only returns once an interrupt disables sleep on exit, and
+ * every sleep in between uses the same depth.
+ *
+ * WFI is executed with interrupts masked, so the wake up is measured before
+ * the handler of the waking interrupt runs, and its handler time is counted as
+ * awake. With sleep on exit, only the first sleep is measured as asleep. The
+ * handlers and sleeps that follow, until this returns, are counted as awake,
+ * thus `sleep_ratio()` is a lower bound.
+ *
+ * @param p_until_deadline - time until the system must next be awake
+ * @return sleep_depth - the depth of sleep that was entered
+ */
+sleep_depth idle(hal::time_duration p_until_deadline);
+
+/**
+ * @brief Sleep until the next event
+ *
+ * Selects the depth of sleep then executes WFE. Returns immediately if an
+ * event occurred since the last WFE.
+ *
+ * Unlike `idle()`, the wake up is measured after the handler of a waking
+ * interrupt has run, so handler time is counted as asleep.
+ *
+ * @param p_until_deadline - time until the system must next be awake
+ * @return sleep_depth - the depth of sleep that was entered
+ */
+sleep_depth idle_until_event(hal::time_duration p_until_deadline);
+
+/**
+ * @brief Get the statistics measured by the idle functions
+ *
+ * Cycles are measured with the DWT cycle counter. Periods of more than 2^32
+ * cycles are under counted, as are cycles in deep sleep on devices which stop
+ * the processor clock in deep sleep.
+ *
+ * @return idle_statistics - statistics since the last reset
+ */
+[[nodiscard]] idle_statistics get_idle_statistics();
+
+/**
+ * @brief Clear the idle statistics
+ *
+ */
+void reset_idle_statistics();
+}  // namespace hal::cortex_m
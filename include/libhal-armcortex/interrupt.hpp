@@ -15,10 +15,13 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <span>
 #include <type_traits>
 
 #include <libhal/error.hpp>
+#include <libhal/functional.hpp>
 
 namespace hal::cortex_m {
 /// Used specifically for defining an interrupt vector table of addresses.
@@ -55,6 +58,7 @@ enum class irq : irq_t
   reserve10 = -6,
   software_call = -5,
   reserve12 = -4,
+  debug_monitor = -4,
   reserve13 = -3,
   pend_sv = -2,
   systick = -1,
@@ -104,6 +108,42 @@ void bus_fault_handler();
  */
 void usage_fault_handler();
 
+/// Maximum number of cores that can share this library's interrupt state.
+/// Each core has its own NVIC and VTOR, so each core is given its own vector
+/// table and handler bookkeeping. The statically allocating initialization
+/// functions only allocate tables for more than one core when their
+/// `core_count` parameter asks for it.
+inline constexpr std::size_t max_cores = 2;
+
+/// Function that returns the number of the core executing it, starting at 0
+using core_id_function = std::uint32_t (*)();
+
+/**
+ * @brief Register the function used to find the executing core
+ *
+ * Every interrupt function operates on the state of the core that calls it.
+ * By default, the executing core is always core 0, which is correct for
+ * single core devices and for devices where each core runs its own image,
+ * such as the STM32H7 dual core devices. Devices where the cores share an
+ * image, such as the RP2040, must register a function that reads the core's
+ * number, such as the SIO CPUID register, before either core initializes its
+ * interrupts. Such devices must also pass a `core_count` of 2 to the
+ * statically allocating initialization functions, such as
+ * `initialize_interrupts<irq::max, 2>()`.
+ *
+ * @param p_core_id - function that returns a value below max_cores. Pass
+ * nullptr to go back to a single core.
+ */
+void set_core_id_source(core_id_function p_core_id);
+
+/**
+ * @brief Get the number of the executing core
+ *
+ * @return std::uint32_t - number of the executing core. Values returned by
+ * the core id source which are not below max_cores are treated as core 0.
+ */
+std::uint32_t current_core();
+
 /**
  * @brief Sets the interrupt vector table back to a form where it can be
  * initialized again().
@@ -136,7 +176,8 @@ void revert_interrupt_vector_table();
  * - Sets the default for bus_fault to `bus_fault_handler`
  * - Sets the default for usage_fault to `usage_fault_handler`
  * - Sets the default for everything else to `nop`
- * - Assign a global vector_table span to the the passed vector table.
+ * - Assign the executing core's vector_table span to the the passed vector
+ *   table.
  * - Relocates the system's interrupt vector table away from the hard coded
  *   vector table in ROM/Flash memory to the table passed in.
  *
@@ -153,7 +194,8 @@ void initialize_interrupts(std::span<interrupt_pointer> p_vector_table);
  *
  * This template function does the following:
  * - Statically allocates a 512-byte aligned an interrupt vector table the
- *   size of max_possible_irq.
+ *   size of max_possible_irq within the `.bss.dtcm` input section, which
+ *   the standard linker scripts place in the `.dtcm_bss` output section.
  * - Calls the initialize_interrupts function with the array.
  *
  * Internally, this function checks if it has been called before and will
@@ -166,21 +208,41 @@ void initialize_interrupts(std::span<interrupt_pointer> p_vector_table);
  * waste space in RAM. Only the first call is used as the IVT.
  *
  * @tparam max_possible_irq - the number of interrupts available for this system
+ * @tparam core_count - number of cores sharing this image that initialize
+ * their interrupts with this function, each given its own table. Does nothing
+ * when called from a core whose `current_core()` is not below core_count.
  */
-template<irq_t max_possible_irq>
+template<irq_t max_possible_irq, std::size_t core_count = 1>
 void initialize_interrupts()
 {
   static_assert(max_possible_irq > 0,
                 "Cannot initialize interrupts using a negative number. Please "
                 "supply a number above 0.");
+  static_assert(0 < core_count && core_count <= max_cores,
+                "core_count must be between 1 and max_cores");
 
   // Statically allocate a buffer of vectors to be used as the new IVT.
   constexpr size_t total_vector_count = max_possible_irq - core_interrupts;
 
-  alignas(512) static std::array<interrupt_pointer, total_vector_count>
-    vector_buffer{};
+  // Placed in DTCM when the application uses `libhal-armcortex/tcm.ld`, which
+  // makes vector fetches deterministic and zero wait state. Otherwise the
+  // section is placed in ram. The `.bss.` prefix makes the section NOBITS, and
+  // linker scripts without a `.dtcm_bss` section collect it into `.bss`.
+  // Each core relocates its VTOR to its own buffer.
+  struct alignas(512) aligned_vector_buffer
+  {
+    std::array<interrupt_pointer, total_vector_count> vectors;
+  };
+#if defined(__arm__)
+  __attribute__((section(".bss.dtcm.vector_table")))
+#endif
+  static std::array<aligned_vector_buffer, core_count> vector_buffers{};
 
-  initialize_interrupts(vector_buffer);
+  auto const core_index = current_core();
+  if (core_index >= core_count) {
+    return;
+  }
+  initialize_interrupts(vector_buffers[core_index].vectors);
 }
 
 /**
@@ -192,11 +254,173 @@ void initialize_interrupts()
  *
  * @tparam enum_vector_count - this parameter should always be set to the
  * `hal::platform::irq::max`.
+ * @tparam core_count - number of cores that initialize their interrupts with
+ * this function
  */
-template<irq_enum auto max_possible_irq>
+template<irq_enum auto max_possible_irq, std::size_t core_count = 1>
 inline void initialize_interrupts()
 {
-  initialize_interrupts<static_cast<irq_t>(max_possible_irq)>();
+  initialize_interrupts<static_cast<irq_t>(max_possible_irq), core_count>();
+}
+
+/**
+ * @brief Called when a static_vector_table is given an invalid irq
+ *
+ * This function is intentionally never defined and not constexpr. Calling it
+ * within a constant expression causes compilation to fail with this function's
+ * name in the error message.
+ */
+void static_vector_table_irq_out_of_range();
+
+/**
+ * @brief An interrupt vector table that is fully built at compile time
+ *
+ * A static_vector_table is intended to be placed into flash memory, directly
+ * following the stack and reset entries emitted at the start of the `.init`
+ * section by `libhal-armcortex/standard.ld`. Placing the object into the
+ * `.vector_table` section does this. Because the table never lives in RAM,
+ * using it costs no RAM and requires no work at startup to fill it.
+ *
+ * The table begins with the non maskable interrupt vector, as the top of stack
+ * and reset vectors are provided by the linker script. Every vector defaults to
+ * the same handlers used by `initialize_interrupts()`.
+ *
+ * Example usage:
+ *
+ *     [[gnu::section(".vector_table"), gnu::used]]
+ *     constexpr auto vectors = hal::cortex_m::static_vector_table<irq::max>()
+ *                                .bind(irq::uart0, uart0_handler)
+ *                                .bind(irq::dma, dma_handler);
+ *
+ *     int main() {
+ *       hal::cortex_m::initialize_interrupts(vectors);
+ *     }
+ *
+ * Once a static_vector_table is in use, `enable_interrupt()` can only enable
+ * IRQs whose handler matches the handler bound at compile time. Drivers that
+ * generate their handlers at runtime, such as `systick_timer`, require a RAM
+ * vector table instead.
+ *
+ * @tparam max_possible_irq - the number of interrupts available for this
+ * system. Can be an irq_t or an enumeration typed irq number.
+ */
+template<auto max_possible_irq>
+class static_vector_table
+{
+public:
+  /// The number of interrupts available for this system as an irq_t
+  static constexpr auto max_irq = static_cast<irq_t>(max_possible_irq);
+
+  static_assert(max_irq > 0,
+                "Cannot initialize interrupts using a negative number. Please "
+                "supply a number above 0.");
+
+  /// The first irq held within this table. The top of stack and reset vectors
+  /// are emitted by the linker script.
+  static constexpr auto first_irq =
+    static_cast<irq_t>(irq::non_maskable_interrupt);
+
+  /// Number of vectors held within this table
+  static constexpr std::size_t vector_count = max_irq - first_irq;
+
+  /**
+   * @brief Construct a vector table filled with the default handlers
+   *
+   */
+  consteval static_vector_table()
+  {
+    vectors.fill(&default_interrupt_handler);
+    vectors[index_of(irq::hard_fault)] = &hard_fault_handler;
+    vectors[index_of(irq::memory_management_fault)] =
+      &memory_management_fault_handler;
+    vectors[index_of(irq::bus_fault)] = &bus_fault_handler;
+    vectors[index_of(irq::usage_fault)] = &usage_fault_handler;
+  }
+
+  /**
+   * @brief Return a copy of this table with the handler bound to the irq
+   *
+   * Fails to compile if the irq is out of range or is the top of stack or
+   * reset vector.
+   *
+   * @param p_irq - irq to bind the handler to
+   * @param p_handler - the interrupt service routine for this irq
+   * @return consteval static_vector_table - the updated vector table
+   */
+  consteval static_vector_table bind(irq_t p_irq,
+                                     interrupt_pointer p_handler) const
+  {
+    if (p_irq < first_irq || max_irq <= p_irq) {
+      static_vector_table_irq_out_of_range();
+    }
+    auto copy = *this;
+    copy.vectors[index_of(p_irq)] = p_handler;
+    return copy;
+  }
+
+  /**
+   * @brief Return a copy of this table with the handler bound to the irq
+   *
+   * Performs the same work as `bind` using the `irq_t` type, but allows enum
+   * class types to be passed.
+   *
+   * @param p_irq - enumeration typed irq number
+   * @param p_handler - the interrupt service routine for this irq
+   * @return consteval static_vector_table - the updated vector table
+   */
+  consteval static_vector_table bind(irq_enum auto p_irq,
+                                     interrupt_pointer p_handler) const
+  {
+    return bind(static_cast<irq_t>(p_irq), p_handler);
+  }
+
+  /// Vectors of the table, starting with the non maskable interrupt
+  std::array<interrupt_pointer, vector_count> vectors{};
+
+private:
+  static constexpr std::size_t index_of(irq_t p_irq)
+  {
+    return static_cast<std::size_t>(p_irq - first_irq);
+  }
+
+  static constexpr std::size_t index_of(irq p_irq)
+  {
+    return index_of(static_cast<irq_t>(p_irq));
+  }
+};
+
+/**
+ * @brief Use a flash resident vector table as the interrupt vector table
+ *
+ * Using this function directly is not recommended. Use the
+ * `initialize_interrupts(static_vector_table const&)` overload instead.
+ *
+ * Relocates VTOR to 2 words before the start of the vectors, where the linker
+ * script places the top of stack and reset vectors, and assigns the global
+ * vector table span to the table so `get_vector_table()` and
+ * `verify_vector_enabled()` continue to work.
+ *
+ * While in use, `initialize_interrupts()` does nothing, so drivers calling it
+ * to make sure interrupts are initialized do not replace the table.
+ *
+ * @param p_vectors - vectors starting at the non maskable interrupt. Must be
+ * placed directly after the top of stack and reset vectors.
+ */
+void initialize_static_interrupts(std::span<interrupt_pointer const> p_vectors);
+
+/**
+ * @brief Use a flash resident static_vector_table as the interrupt vector table
+ *
+ * If this table is already in use, this function does nothing.
+ *
+ * @tparam max_possible_irq - the number of interrupts available for this system
+ * @param p_table - vector table placed into the `.vector_table` section
+ */
+template<auto max_possible_irq>
+inline void initialize_interrupts(
+  static_vector_table<max_possible_irq> const& p_table)
+{
+  initialize_static_interrupts(p_table.vectors);
 }
 
 /**
@@ -229,6 +453,72 @@ void disable_all_interrupts();
  */
 void enable_all_interrupts();
 
+/**
+ * @brief RAII critical section that masks interrupts for its lifetime
+ *
+ * On ARMv7-M and ARMv8-M mainline devices (Cortex M3 and above, excluding
+ * M23), this raises the BASEPRI register to the threshold priority. Only
+ * interrupts with a priority value greater than or equal to the threshold are
+ * masked. Interrupts with a more urgent priority continue to be serviced,
+ * meaning hard real time interrupts that do not access the protected state
+ * are not delayed by the critical section.
+ *
+ * On ARMv6-M and ARMv8-M baseline devices (Cortex M0, M0+, M1 and M23) there
+ * is no BASEPRI register. On these devices the PRIMASK register is saved and
+ * all interrupts are masked.
+ *
+ * The previous mask is restored on destruction which allows critical sections
+ * to be nested. A nested critical section can only ever raise the masking
+ * level, never lower it.
+ *
+ * Example usage:
+ *
+ *     {
+ *       hal::cortex_m::critical_section lock(priority_level<4, 2>());
+ *       // IRQs at levels 2 to 15 are masked, IRQs at levels 0 and 1 are live
+ *       shared_state++;
+ *     }
+ *
+ */
+class critical_section
+{
+public:
+  /**
+   * @brief Enter the critical section
+   *
+   * @param p_threshold - 8-bit priority value, in the same format as
+   * `set_priority()`, at and above which interrupts will be masked. A BASEPRI
+   * of zero disables masking, thus a threshold of zero, or one that is zero
+   * within the implemented priority bits, masks every configurable interrupt
+   * with PRIMASK instead.
+   */
+  explicit critical_section(std::uint8_t p_threshold);
+
+  /**
+   * @brief Enter a critical section that masks every configurable interrupt
+   *
+   * Saves and sets the PRIMASK register on all devices. Use this when the
+   * protected state is shared with interrupts of any priority, such as state
+   * owned by a driver that cannot know the priority of its callers.
+   */
+  critical_section();
+
+  critical_section(critical_section const&) = delete;
+  critical_section& operator=(critical_section const&) = delete;
+  critical_section(critical_section&&) = delete;
+  critical_section& operator=(critical_section&&) = delete;
+
+  /**
+   * @brief Leave the critical section and restore the previous mask
+   *
+   */
+  ~critical_section();
+
+private:
+  std::uint32_t m_previous_mask = 0;
+  bool m_masks_all = false;
+};
+
 /**
  * @brief Get a reference to interrupt vector table object
  *
@@ -236,6 +526,114 @@ void enable_all_interrupts();
  */
 std::span<interrupt_pointer> const get_vector_table();
 
+/**
+ * @brief Statistics recorded for an interrupt by the instrumented dispatcher
+ *
+ */
+struct irq_statistics
+{
+  /// Number of times the handler was entered
+  std::uint32_t entries = 0;
+  /// Longest time spent in a single run of the handler, in CPU cycles
+  std::uint32_t max_cycles = 0;
+  /// Total time spent in the handler, in CPU cycles
+  std::uint64_t total_cycles = 0;
+  /// Deepest interrupt nesting level observed on entry to the handler, where 1
+  /// means the handler did not preempt another instrumented handler.
+  std::uint8_t max_nesting = 0;
+};
+
+/**
+ * @brief Switch interrupt dispatch to the instrumented mode
+ *
+ * Using this function directly is not recommended. Use
+ * `initialize_interrupt_statistics<irq::max>()` instead.
+ *
+ * Every vector, other than the top of stack and reset vectors, is redirected
+ * through a trampoline that looks up the handler of the active exception,
+ * runs it and records statistics about it. Handlers installed before and after
+ * this call are instrumented, except for the NMI, HardFault, MemManage,
+ * BusFault, UsageFault, SVCall and PendSV handlers. The fault, SVCall and
+ * PendSV handlers rely on the link register holding EXC_RETURN or on the stack
+ * frame of the code they preempt, such as `fault_capture_handler()` and the
+ * context switch handler. NMI cannot be masked while the statistics of the
+ * handler it preempts are updated. These always run directly from the vector
+ * table and no statistics are recorded for them.
+ *
+ * The cycle counter of the DWT is used for timing and is enabled by this
+ * call, thus this mode is supported for Cortex M3 devices and above.
+ *
+ * Cycles spent in nested interrupts are not counted against the interrupt
+ * they preempted, making the cycle counts a measure of how much CPU time each
+ * handler consumes.
+ *
+ * Does nothing if the interrupt vector table has not been initialized, is a
+ * flash resident static_vector_table, or if the buffers are smaller than the
+ * vector table.
+ *
+ * @param p_handlers - storage for the handlers of each vector. Must be at least
+ * as large as the vector table including the core interrupts.
+ * @param p_statistics - storage for the statistics of each vector. Must be the
+ * same size as p_handlers.
+ */
+void initialize_interrupt_statistics(std::span<interrupt_pointer> p_handlers,
+                                     std::span<irq_statistics> p_statistics);
+
+/**
+ * @brief Switch interrupt dispatch to the instrumented mode
+ *
+ * Statically allocates storage for the handlers and statistics of each vector
+ * and calls `initialize_interrupt_statistics()` with them. Call this after
+ * `initialize_interrupts<max_possible_irq>()`. Code that never calls this
+ * function pays nothing for the instrumented mode other than a branch within
+ * `enable_interrupt()`.
+ *
+ * @tparam max_possible_irq - the number of interrupts available for this system
+ * @tparam core_count - number of cores that record statistics, each given its
+ * own storage. Does nothing when called from a core whose `current_core()` is
+ * not below core_count.
+ */
+template<auto max_possible_irq, std::size_t core_count = 1>
+void initialize_interrupt_statistics()
+{
+  static_assert(0 < core_count && core_count <= max_cores,
+                "core_count must be between 1 and max_cores");
+
+  constexpr auto total_vector_count =
+    static_cast<std::size_t>(static_cast<irq_t>(max_possible_irq) -
+                             core_interrupts);
+
+  using handler_buffer = std::array<interrupt_pointer, total_vector_count>;
+  using statistics_buffer = std::array<irq_statistics, total_vector_count>;
+  static std::array<handler_buffer, core_count> handlers{};
+  static std::array<statistics_buffer, core_count> statistics{};
+
+  auto const core_index = current_core();
+  if (core_index >= core_count) {
+    return;
+  }
+  initialize_interrupt_statistics(handlers[core_index],
+                                  statistics[core_index]);
+}
+
+/**
+ * @brief Get the statistics recorded by the instrumented dispatcher
+ *
+ * The statistics are indexed by exception number, which is the irq plus 16,
+ * matching the layout of the interrupt vector table in memory. Thus the
+ * statistics of `irq::systick` are at index 15 and IRQ 0 is at index 16.
+ *
+ * @return std::span<irq_statistics const> - statistics of each vector or an
+ * empty span if the instrumented mode is not in use.
+ */
+std::span<irq_statistics const> get_interrupt_statistics();
+
+/**
+ * @brief Clear the statistics of every vector
+ *
+ */
+void reset_interrupt_statistics();
+
 /**
  * @brief Enable interrupt and set the service routine handler.
  *
@@ -289,6 +687,409 @@ inline void disable_interrupt(irq_enum auto p_irq)
   disable_interrupt(static_cast<irq_t>(p_irq));
 }
 
+/**
+ * @brief Called when an irq_set is given an invalid irq
+ *
+ * This function is intentionally never defined and not constexpr. Calling it
+ * within a constant expression causes compilation to fail with this function's
+ * name in the error message.
+ */
+void irq_set_irq_out_of_range();
+
+/**
+ * @brief A set of IRQs held as a bitmask for each NVIC register
+ *
+ * The masks are computed at compile time, so enabling, disabling or pending
+ * every IRQ of a set costs a single store per 32 IRQs. Only IRQs 0 and above
+ * belong to the NVIC, core interrupts cannot be placed within a set.
+ *
+ * Example usage:
+ *
+ *     constexpr hal::cortex_m::irq_set adc_group(irq::adc0, irq::adc1);
+ *     hal::cortex_m::enable_interrupts(adc_group);
+ *
+ */
+class irq_set
+{
+public:
+  /// Number of 32-bit NVIC registers covering every possible IRQ
+  static constexpr std::size_t register_count = 8;
+  /// Number of IRQs that fit within the set
+  static constexpr irq_t max_irq = register_count * 32;
+
+  /**
+   * @brief Construct a set containing the irqs
+   *
+   * Fails to compile if an irq is negative or beyond the range of the NVIC.
+   *
+   * @param p_irqs - irqs to place in the set, irq_t or enumeration typed
+   */
+  template<typename... irqs>
+    requires((std::is_integral_v<irqs> || irq_enum<irqs>) && ...)
+  consteval explicit irq_set(irqs... p_irqs)
+  {
+    (insert(static_cast<irq_t>(p_irqs)), ...);
+  }
+
+  /**
+   * @brief Return a copy of this set with the irq added
+   *
+   * @param p_irq - irq to add
+   * @return consteval irq_set - the updated set
+   */
+  consteval irq_set with(irq_t p_irq) const
+  {
+    auto copy = *this;
+    copy.insert(p_irq);
+    return copy;
+  }
+
+  /**
+   * @brief Return a copy of this set with the irq added
+   *
+   * @param p_irq - enumeration typed irq to add
+   * @return consteval irq_set - the updated set
+   */
+  consteval irq_set with(irq_enum auto p_irq) const
+  {
+    return with(static_cast<irq_t>(p_irq));
+  }
+
+  /**
+   * @brief Determine if the irq is within the set
+   *
+   * @param p_irq - irq to check
+   * @return true - if the irq is within the set
+   */
+  [[nodiscard]] constexpr bool contains(irq_t p_irq) const
+  {
+    if (p_irq < 0 || max_irq <= p_irq) {
+      return false;
+    }
+    return (m_masks[p_irq / 32] & (1U << (p_irq % 32))) != 0U;
+  }
+
+  /**
+   * @brief Get the bitmask of the irqs within one NVIC register
+   *
+   * @param p_index - index of the register, irqs 32 * p_index to
+   * 32 * p_index + 31
+   * @return constexpr std::uint32_t - the mask of irqs within the register
+   */
+  [[nodiscard]] constexpr std::uint32_t mask(std::size_t p_index) const
+  {
+    return m_masks[p_index];
+  }
+
+private:
+  constexpr void insert(irq_t p_irq)
+  {
+    if (p_irq < 0 || max_irq <= p_irq) {
+      irq_set_irq_out_of_range();
+    }
+    m_masks[p_irq / 32] |= 1U << (p_irq % 32);
+  }
+
+  std::array<std::uint32_t, register_count> m_masks{};
+};
+
+/**
+ * @brief Enable every irq within the set
+ *
+ * Interrupts are masked while the enable registers are written, so every irq
+ * of the set is enabled at the same instant. Any of them that were already
+ * pending are then taken in priority order. Handlers are not modified.
+ *
+ * Does nothing if the vector table has not been initialized. IRQs beyond the
+ * range of the interrupt vector table are ignored.
+ *
+ * @param p_irqs - irqs to enable
+ */
+void enable_interrupts(irq_set const& p_irqs);
+
+/**
+ * @brief Disable every irq within the set
+ *
+ * Does nothing if the vector table has not been initialized. IRQs beyond the
+ * range of the interrupt vector table are ignored.
+ *
+ * @param p_irqs - irqs to disable
+ */
+void disable_interrupts(irq_set const& p_irqs);
+
+/**
+ * @brief Set every irq within the set to pending
+ *
+ * Does nothing if the vector table has not been initialized. IRQs beyond the
+ * range of the interrupt vector table are ignored.
+ *
+ * @param p_irqs - irqs to pend
+ */
+void pend_interrupts(irq_set const& p_irqs);
+
+/**
+ * @brief Clear the pending state of every irq within the set
+ *
+ * Does nothing if the vector table has not been initialized. IRQs beyond the
+ * range of the interrupt vector table are ignored.
+ *
+ * @param p_irqs - irqs to clear
+ */
+void clear_pending_interrupts(irq_set const& p_irqs);
+
+/**
+ * @brief An irq and the handler to install for it
+ *
+ */
+struct interrupt_binding
+{
+  /// irq to enable
+  irq_t irq;
+  /// Handler to install for the irq
+  interrupt_pointer handler;
+};
+
+/**
+ * @brief Install many interrupt handlers and enable their irqs
+ *
+ * Performs the same work as calling `enable_interrupt()` for each binding,
+ * but validates the vector table once and enables the irqs with a single
+ * store per NVIC register, with interrupts masked such that every irq is
+ * enabled at the same instant.
+ *
+ * Bindings with invalid irqs are skipped. Core interrupts have their handler
+ * installed, but have no enable bit.
+ *
+ * @param p_bindings - the irqs and their handlers
+ */
+void enable_interrupts(std::span<interrupt_binding const> p_bindings);
+
+/// Handler of an irq that was attached with `attach_interrupt()`
+using irq_callback = hal::callback<void(void)>;
+
+/**
+ * @brief Vector that calls every callback attached to the active irq
+ *
+ * `attach_interrupt()` installs this into the vector table. Applications using
+ * a `static_vector_table` must bind this to every irq that drivers attach
+ * callbacks to.
+ *
+ */
+void dispatch_irq_callbacks();
+
+/**
+ * @brief Initialize the callback dispatch table of the executing core
+ *
+ * Using this function directly is not recommended. Use the templated version
+ * of this function, which statically allocates the table.
+ *
+ * Does nothing if the table has already been initialized, or if the vector
+ * table has not been initialized or the storage is too small for it.
+ *
+ * @param p_callbacks - storage for `p_callbacks_per_irq` callbacks for each
+ * vector of the vector table, including the core interrupts. The storage must
+ * outlive the use of interrupts.
+ * @param p_callbacks_per_irq - number of callbacks that can share each irq
+ */
+void initialize_irq_dispatch(std::span<irq_callback> p_callbacks,
+                             std::size_t p_callbacks_per_irq);
+
+/**
+ * @brief Statically allocate and initialize the callback dispatch table
+ *
+ * Call this after `initialize_interrupts<max_possible_irq>()` with the same
+ * max_possible_irq. Like `initialize_interrupts<>()`, it is safe to call this
+ * multiple times, so drivers that attach callbacks should call this first.
+ *
+ * @tparam max_possible_irq - the number of interrupts available for this system
+ * @tparam callbacks_per_irq - number of callbacks that can share each irq
+ * @tparam core_count - number of cores that dispatch callbacks, each given its
+ * own table. Does nothing when called from a core whose `current_core()` is
+ * not below core_count.
+ */
+template<auto max_possible_irq,
+         std::size_t callbacks_per_irq = 2,
+         std::size_t core_count = 1>
+void initialize_irq_dispatch()
+{
+  static_assert(callbacks_per_irq > 0,
+                "At least one callback must be available for each irq");
+  static_assert(0 < core_count && core_count <= max_cores,
+                "core_count must be between 1 and max_cores");
+
+  constexpr auto total_vector_count =
+    static_cast<std::size_t>(static_cast<irq_t>(max_possible_irq) -
+                             core_interrupts);
+
+  using callback_buffer =
+    std::array<irq_callback, total_vector_count * callbacks_per_irq>;
+  static std::array<callback_buffer, core_count> callbacks{};
+
+  auto const core_index = current_core();
+  if (core_index >= core_count) {
+    return;
+  }
+  initialize_irq_dispatch(callbacks[core_index], callbacks_per_irq);
+}
+
+/**
+ * @brief Attach a callback to an irq and enable the irq
+ *
+ * Several callbacks, up to the callbacks_per_irq of the dispatch table, can
+ * be attached to the same irq, such that drivers can share an interrupt line
+ * and do not need a trampoline of their own to call a member function. When
+ * the irq fires, its callbacks are called in the order they were attached.
+ *
+ * Does nothing if the irq is invalid, or is the top of stack or reset vector.
+ * The irq is not enabled if the vector table is a static vector table which
+ * does not bind `dispatch_irq_callbacks` to this irq.
+ *
+ * @param p_irq - irq to attach the callback to
+ * @param p_callback - callback to call when the irq fires
+ * @throws hal::operation_not_permitted - if the dispatch table has not been
+ * initialized.
+ * @throws hal::resource_unavailable_try_again - if every callback of this irq
+ * is in use.
+ */
+void attach_interrupt(irq_t p_irq, irq_callback p_callback);
+
+/**
+ * @brief Attach a callback to an irq and enable the irq
+ *
+ * Performs the same work as `attach_interrupt(irq_t, irq_callback)`, but
+ * accepts an enumeration class object.
+ *
+ * @param p_irq - irq to attach the callback to
+ * @param p_callback - callback to call when the irq fires
+ * @throws hal::operation_not_permitted - if the dispatch table has not been
+ * initialized.
+ * @throws hal::resource_unavailable_try_again - if every callback of this irq
+ * is in use.
+ */
+inline void attach_interrupt(irq_enum auto p_irq, irq_callback p_callback)
+{
+  attach_interrupt(static_cast<irq_t>(p_irq), p_callback);
+}
+
+/**
+ * @brief Disable an irq and detach every callback attached to it
+ *
+ * Does nothing if the irq is invalid or the dispatch table has not been
+ * initialized.
+ *
+ * @param p_irq - irq to detach the callbacks of
+ */
+void detach_interrupts(irq_t p_irq);
+
+/**
+ * @brief Disable an irq and detach every callback attached to it
+ *
+ * Performs the same work as `detach_interrupts(irq_t)`, but accepts an
+ * enumeration class object.
+ *
+ * @param p_irq - irq to detach the callbacks of
+ */
+inline void detach_interrupts(irq_enum auto p_irq)
+{
+  detach_interrupts(static_cast<irq_t>(p_irq));
+}
+
+/**
+ * @brief Set an interrupt to pending from software
+ *
+ * Uses the Software Trigger Interrupt Register on ARMv7-M and ARMv8-M
+ * mainline, which takes a single store without a read-modify-write, and the
+ * NVIC's set pending registers on other devices. The interrupt is taken once
+ * it is enabled and its priority allows it to preempt the running code, so
+ * spare vendor IRQs can be used as prioritized software event channels.
+ *
+ * `irq::pend_sv` and `irq::systick` are pended through the Interrupt Control
+ * and State Register. Does nothing for any other core interrupt or if the irq
+ * is beyond the range of the interrupt vector table.
+ *
+ * @param p_irq - irq to trigger
+ */
+void trigger_interrupt(irq_t p_irq);
+
+/**
+ * @brief Set an interrupt to pending from software
+ *
+ * @param p_irq - enumeration typed irq number
+ */
+inline void trigger_interrupt(irq_enum auto p_irq)
+{
+  trigger_interrupt(static_cast<irq_t>(p_irq));
+}
+
+/**
+ * @brief Determine if an interrupt is pending
+ *
+ * Supports IRQs 0 and above, `irq::pend_sv` and `irq::systick`.
+ *
+ * @param p_irq - irq to check
+ * @return true - if the interrupt is waiting to be taken
+ * @return false - if it is not pending or the irq is not supported
+ */
+[[nodiscard]] bool is_pending(irq_t p_irq);
+
+/**
+ * @brief Determine if an interrupt is pending
+ *
+ * @param p_irq - enumeration typed irq number
+ * @return true - if the interrupt is waiting to be taken
+ */
+[[nodiscard]] inline bool is_pending(irq_enum auto p_irq)
+{
+  return is_pending(static_cast<irq_t>(p_irq));
+}
+
+/**
+ * @brief Clear the pending state of an interrupt
+ *
+ * Supports IRQs 0 and above, `irq::pend_sv` and `irq::systick`, and does
+ * nothing for any other irq.
+ *
+ * @param p_irq - irq to clear
+ */
+void clear_pending(irq_t p_irq);
+
+/**
+ * @brief Clear the pending state of an interrupt
+ *
+ * @param p_irq - enumeration typed irq number
+ */
+inline void clear_pending(irq_enum auto p_irq)
+{
+  clear_pending(static_cast<irq_t>(p_irq));
+}
+
+/**
+ * @brief Determine if an interrupt is active
+ *
+ * An interrupt is active from the time it is taken until its handler returns,
+ * including while it is preempted by a higher priority interrupt. Supports
+ * IRQs 0 and above, `irq::pend_sv` and `irq::systick`.
+ *
+ * Unsupported on ARMv6-M devices (Cortex M0, M0+ and M1), which do not expose
+ * the active state of interrupts, thus this always returns false on them.
+ *
+ * @param p_irq - irq to check
+ * @return true - if the interrupt's handler is running or preempted
+ * @return false - if it is not active or the irq is not supported
+ */
+[[nodiscard]] bool is_active(irq_t p_irq);
+
+/**
+ * @brief Determine if an interrupt is active
+ *
+ * @param p_irq - enumeration typed irq number
+ * @return true - if the interrupt's handler is running or preempted
+ */
+[[nodiscard]] inline bool is_active(irq_enum auto p_irq)
+{
+  return is_active(static_cast<irq_t>(p_irq));
+}
+
 /**
  * @brief determine if a particular handler has been put into the interrupt
  * vector table.
@@ -322,4 +1123,119 @@ inline void disable_interrupt(irq_enum auto p_irq)
 {
   return verify_vector_enabled(static_cast<irq_t>(p_irq), p_handler);
 }
+
+/**
+ * @brief Compute the 8-bit priority register value for a priority level
+ *
+ * ARM Cortex-M devices implement between 2 and 8 bits of interrupt priority.
+ * The implemented bits are always the most significant bits of each 8-bit
+ * priority field. This function shifts a logical priority level into those
+ * bits and fails to compile if the level cannot be represented by the device.
+ *
+ * Lower levels have higher urgency, with 0 being the most urgent level.
+ *
+ * Example usage:
+ *
+ *     // lpc40 devices implement 5 priority bits
+ *     set_priority(irq::uart0, priority_level<5, 3>());
+ *
+ * @tparam implemented_bits - number of priority bits implemented by the device
+ * @tparam level - logical priority level to convert
+ * @return constexpr std::uint8_t - value to be passed to `set_priority()`
+ */
+template<std::uint8_t implemented_bits, std::uint8_t level>
+constexpr std::uint8_t priority_level()
+{
+  static_assert(2 <= implemented_bits && implemented_bits <= 8,
+                "ARM Cortex-M devices implement between 2 and 8 priority "
+                "bits.");
+  static_assert(level < (1U << implemented_bits),
+                "Priority level does not fit within the number of priority "
+                "bits implemented by this device.");
+  return static_cast<std::uint8_t>(level << (8U - implemented_bits));
+}
+
+/**
+ * @brief Set the priority of an interrupt
+ *
+ * For IRQs 0 and above, the priority is written to the NVIC's interrupt
+ * priority registers. For the configurable core interrupts (memory management
+ * fault, bus fault, usage fault, software call, pend_sv and systick), the
+ * priority is written to the system handler priority registers.
+ *
+ * The unimplemented least significant bits of the priority are ignored by the
+ * hardware. Use `priority_level()` to generate a value with a compile time
+ * check that it fits the device's priority bits.
+ *
+ * This function does nothing if the vector table has not been initialized, if
+ * the irq is out of range or if the irq has a fixed priority (reset,
+ * non_maskable_interrupt and hard_fault).
+ *
+ * @param p_irq - irq to set the priority of
+ * @param p_priority - 8-bit priority value, lower values are more urgent
+ */
+void set_priority(irq_t p_irq, std::uint8_t p_priority);
+
+/**
+ * @brief Set the priority of an interrupt
+ *
+ * Performs the same work as `set_priority` using the `irq_t` type, but
+ * allows enum class types to be passed.
+ *
+ * @param p_irq - enumeration typed irq number
+ * @param p_priority - 8-bit priority value, lower values are more urgent
+ */
+inline void set_priority(irq_enum auto p_irq, std::uint8_t p_priority)
+{
+  set_priority(static_cast<irq_t>(p_irq), p_priority);
+}
+
+/**
+ * @brief Get the priority of an interrupt
+ *
+ * @param p_irq - irq to get the priority of
+ * @return std::uint8_t - the 8-bit priority value of the interrupt with the
+ * unimplemented bits reading as zero. Returns 0 if the irq is invalid or has a
+ * fixed priority.
+ */
+[[nodiscard]] std::uint8_t get_priority(irq_t p_irq);
+
+/**
+ * @brief Get the priority of an interrupt
+ *
+ * Performs the same work as `get_priority` using the `irq_t` type, but
+ * allows enum class types to be passed.
+ *
+ * @param p_irq - enumeration typed irq number
+ * @return std::uint8_t - the 8-bit priority value of the interrupt
+ */
+[[nodiscard]] inline std::uint8_t get_priority(irq_enum auto p_irq)
+{
+  return get_priority(static_cast<irq_t>(p_irq));
+}
+
+/**
+ * @brief Set the priority grouping of the interrupt controller
+ *
+ * The priority grouping (PRIGROUP) splits each 8-bit priority value into a
+ * group priority field, which determines preemption, and a subpriority
+ * field, which only determines the order of pending interrupts of the same
+ * group priority. Bits [7:p_grouping + 1] are the group priority and bits
+ * [p_grouping:0] are the subpriority. A value of 0 dedicates all implemented
+ * bits to preemption.
+ *
+ * Priority grouping is not available on ARMv6-M devices (Cortex M0, M0+ and
+ * M1) and the value will be ignored by the hardware.
+ *
+ * @param p_grouping - priority grouping value between 0 and 7. Values above 7
+ * are truncated to 3 bits.
+ */
+void set_priority_grouping(std::uint8_t p_grouping);
+
+/**
+ * @brief Get the priority grouping of the interrupt controller
+ *
+ * @return std::uint8_t - priority grouping value between 0 and 7
+ */
+[[nodiscard]] std::uint8_t get_priority_grouping();
 }  // namespace hal::cortex_m
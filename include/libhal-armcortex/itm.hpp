@@ -0,0 +1,118 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <libhal/serial.hpp>
+#include <libhal/units.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief Settings for the ITM and its SWO output
+ *
+ */
+struct itm_settings
+{
+  /// Frequency of the trace clock feeding the TPIU. On most devices this is
+  /// the CPU clock.
+  hertz trace_clock;
+  /// Baud rate of the SWO pin. Must evenly divide into the trace clock for
+  /// most debug probes to decode the stream.
+  hertz baud_rate = 2'000'000.0f;
+  /// Bit N enables stimulus port N. Only ports 0 to 31 can be enabled.
+  std::uint32_t enabled_ports = 1U << 0U;
+  /// Emit local timestamp packets, stamping each stimulus write with the
+  /// number of cycles since the previous packet.
+  bool timestamps = false;
+  /// Emit periodic program counter samples generated by the DWT. Useful for
+  /// statistical profiling through the debug probe. A sample is emitted every
+  /// 16,384 cycles.
+  bool pc_sampling = false;
+};
+
+/**
+ * @brief Configure the ITM, TPIU and SWO pin for tracing
+ *
+ * This driver is supported for Cortex M3 devices and above.
+ *
+ * The platform is responsible for routing the SWO signal to its pin and
+ * enabling the trace clock, if required, before calling this.
+ *
+ * @param p_settings - ITM settings
+ * @throws hal::argument_out_of_domain - if the baud rate cannot be generated
+ * from the trace clock.
+ */
+void initialize_itm(itm_settings const& p_settings);
+
+/**
+ * @brief Determine if writes to a stimulus port will be emitted
+ *
+ * @param p_port - stimulus port number
+ * @return true - if the ITM and the port are enabled
+ */
+[[nodiscard]] bool itm_port_enabled(std::uint8_t p_port);
+
+/**
+ * @brief Write a 32-bit word to a stimulus port
+ *
+ * Waits for the port's FIFO to become ready and then performs a single store.
+ * The write is dropped if the ITM or the port is disabled, which happens when
+ * no debug probe has enabled it, so logging never blocks without a probe.
+ *
+ * @param p_port - stimulus port number
+ * @param p_word - word to emit
+ */
+void itm_write(std::uint8_t p_port, std::uint32_t p_word);
+
+/**
+ * @brief Write a single byte to a stimulus port
+ *
+ * Same as `itm_write()` but emits an 8-bit packet.
+ *
+ * @param p_port - stimulus port number
+ * @param p_byte - byte to emit
+ */
+void itm_write_byte(std::uint8_t p_port, hal::byte p_byte);
+
+/**
+ * @brief hal::serial sink that writes to an ITM stimulus port
+ *
+ * Data is packed into 32-bit stimulus writes with any trailing bytes written
+ * individually, so each 4 bytes of log output cost a single store. The ITM is
+ * a transmit only interface, thus reads never return data. The SWO baud rate
+ * is set by `initialize_itm()` and is not changed by `configure()`.
+ */
+class itm_serial : public hal::serial
+{
+public:
+  /**
+   * @brief Construct a serial sink for a stimulus port
+   *
+   * @param p_port - stimulus port to write to. Port 0 is conventionally used
+   * for text output.
+   */
+  explicit itm_serial(std::uint8_t p_port = 0);
+
+private:
+  void driver_configure(settings const& p_settings) override;
+  write_t driver_write(std::span<hal::byte const> p_data) override;
+  read_t driver_read(std::span<hal::byte> p_data) override;
+  void driver_flush() override;
+
+  std::uint8_t m_port;
+};
+}  // namespace hal::cortex_m
@@ -0,0 +1,344 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace hal::cortex_m {
+/**
+ * @brief Memory types and cache policies that can be assigned to a region
+ *
+ * On ARMv7-M these map to the TEX, C and B bits of the region. On ARMv8-M
+ * these map to a fixed set of memory attribute indirection (MAIR) entries.
+ */
+enum class mpu_memory_type : std::uint8_t
+{
+  /// Strongly ordered memory. Accesses are never buffered, merged or cached.
+  strongly_ordered = 0,
+  /// Device memory, used for peripheral registers.
+  device = 1,
+  /// Normal memory that is never cached. Use this for DMA buffers that should
+  /// not require cache maintenance.
+  normal_non_cacheable = 2,
+  /// Normal memory, write-through and no write allocate. Reads are cached and
+  /// writes always reach memory.
+  normal_write_through = 3,
+  /// Normal memory, write-back with read and write allocate. Gives the best
+  /// performance for flash and general purpose SRAM.
+  normal_write_back_write_allocate = 4,
+  /// Normal memory, write-back with read allocate only.
+  normal_write_back_no_write_allocate = 5,
+};
+
+/**
+ * @brief Access permissions that can be assigned to a region
+ *
+ * Only permissions that are common to the ARMv7-M and ARMv8-M MPUs are
+ * provided. Regions that should not be accessed at all should be left out of
+ * the MPU table.
+ */
+enum class mpu_access : std::uint8_t
+{
+  /// Read & write from privileged code only
+  privileged_read_write = 0,
+  /// Read & write from privileged and unprivileged code
+  read_write = 1,
+  /// Read only from privileged code only
+  privileged_read_only = 2,
+  /// Read only from privileged and unprivileged code
+  read_only = 3,
+};
+
+/**
+ * @brief Description of a memory region protected by the MPU
+ *
+ * ARMv7-M requires that the size is a power of 2 of at least 32 bytes and that
+ * the base address is aligned to the size. ARMv8-M requires that the base
+ * address and size are multiples of 32 bytes. Both are checked at compile time
+ * by `make_mpu_table()`.
+ */
+struct mpu_region
+{
+  /// Start address of the region
+  std::uint32_t base;
+  /// Size of the region in bytes
+  std::uint32_t size;
+  /// Memory type and cache policy of the region
+  mpu_memory_type type = mpu_memory_type::normal_write_back_write_allocate;
+  /// Access permissions of the region
+  mpu_access access = mpu_access::read_write;
+  /// Set to true if the region is shared between multiple bus masters
+  bool shareable = false;
+  /// Set to true to fault on instruction fetches from this region
+  bool execute_never = false;
+};
+
+/**
+ * @brief The MPU programmers model supported by the processor
+ *
+ */
+enum class mpu_architecture : std::uint8_t
+{
+  /// ARMv7-M & ARMv6-M RBAR/RASR based MPU
+  armv7m = 0,
+  /// ARMv8-M RBAR/RLAR and MAIR based MPU
+  armv8m = 1,
+};
+
+#if defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8M_BASE__) ||         \
+  defined(__ARM_ARCH_8_1M_MAIN__)
+/// The MPU architecture of the processor this code is compiled for
+inline constexpr auto native_mpu_architecture = mpu_architecture::armv8m;
+#else
+/// The MPU architecture of the processor this code is compiled for
+inline constexpr auto native_mpu_architecture = mpu_architecture::armv7m;
+#endif
+
+/**
+ * @brief The register values that program a single MPU region
+ *
+ */
+struct mpu_region_registers
+{
+  /// Region base address register value
+  std::uint32_t rbar;
+  /// ARMv7-M region attribute and size register (RASR) or ARMv8-M region
+  /// limit address register (RLAR) value
+  std::uint32_t rasr_or_rlar;
+};
+
+/**
+ * @brief Called when an mpu_region does not meet the MPU's requirements
+ *
+ * This function is intentionally never defined and not constexpr. Calling it
+ * within a constant expression causes compilation to fail with this function's
+ * name in the error message.
+ */
+void mpu_region_is_invalid();
+
+/**
+ * @brief Encode a region for the ARMv7-M MPU
+ *
+ * @param p_region - region to encode
+ * @return constexpr mpu_region_registers - RBAR and RASR values for the region
+ */
+constexpr mpu_region_registers encode_armv7m_mpu_region(
+  mpu_region const& p_region)
+{
+  constexpr std::uint32_t minimum_size = 32;
+  bool const power_of_two = (p_region.size & (p_region.size - 1)) == 0;
+  if (p_region.size < minimum_size || not power_of_two ||
+      (p_region.base & (p_region.size - 1)) != 0) {
+    mpu_region_is_invalid();
+  }
+
+  std::uint32_t size_field = 0;
+  while ((std::uint32_t{ 2 } << size_field) < p_region.size) {
+    size_field++;
+  }
+
+  // TEX, C & B bits for each mpu_memory_type
+  constexpr std::array<std::uint32_t, 6> type_bits{
+    0b000'0'0,  // strongly_ordered
+    0b000'0'1,  // device
+    0b001'0'0,  // normal_non_cacheable
+    0b000'1'0,  // normal_write_through
+    0b001'1'1,  // normal_write_back_write_allocate
+    0b000'1'1,  // normal_write_back_no_write_allocate
+  };
+
+  // AP bits for each mpu_access
+  constexpr std::array<std::uint32_t, 4> access_bits{
+    0b001,  // privileged_read_write
+    0b011,  // read_write
+    0b101,  // privileged_read_only
+    0b110,  // read_only
+  };
+
+  auto const type = type_bits[static_cast<std::size_t>(p_region.type)];
+  auto const access = access_bits[static_cast<std::size_t>(p_region.access)];
+
+  std::uint32_t rasr = 1U;  // Region enable
+  rasr |= size_field << 1U;
+  rasr |= (type & 0b11U) << 16U;  // C & B
+  rasr |= std::uint32_t{ p_region.shareable } << 18U;
+  rasr |= (type >> 2U) << 19U;  // TEX
+  rasr |= access << 24U;
+  rasr |= std::uint32_t{ p_region.execute_never } << 28U;
+
+  return { .rbar = p_region.base, .rasr_or_rlar = rasr };
+}
+
+/**
+ * @brief Memory attribute indirection register (MAIR) values used for ARMv8-M
+ *
+ * Attribute index N of MAIR0/MAIR1 holds the attributes of the mpu_memory_type
+ * with the value N.
+ */
+inline constexpr std::array<std::uint32_t, 2> armv8m_mpu_attributes{
+  // strongly_ordered: Device-nGnRnE
+  // device: Device-nGnRE
+  // normal_non_cacheable: Normal, inner & outer non-cacheable
+  // normal_write_through: Normal, inner & outer write-through, read allocate
+  (0x00U << 0U) | (0x04U << 8U) | (0x44U << 16U) | (0xAAU << 24U),
+  // normal_write_back_write_allocate: Normal, write-back, read/write allocate
+  // normal_write_back_no_write_allocate: Normal, write-back, read allocate
+  (0xFFU << 0U) | (0xEEU << 8U),
+};
+
+/**
+ * @brief Encode a region for the ARMv8-M MPU
+ *
+ * @param p_region - region to encode
+ * @return constexpr mpu_region_registers - RBAR and RLAR values for the region
+ */
+constexpr mpu_region_registers encode_armv8m_mpu_region(
+  mpu_region const& p_region)
+{
+  constexpr std::uint32_t granule_mask = 32 - 1;
+  if (p_region.size == 0 || (p_region.size & granule_mask) != 0 ||
+      (p_region.base & granule_mask) != 0) {
+    mpu_region_is_invalid();
+  }
+
+  constexpr std::uint32_t inner_shareable = 0b11;
+
+  std::uint32_t rbar = p_region.base;
+  rbar |= std::uint32_t{ p_region.execute_never } << 0U;
+  rbar |= static_cast<std::uint32_t>(p_region.access) << 1U;
+  rbar |= (p_region.shareable ? inner_shareable : 0U) << 3U;
+
+  std::uint32_t rlar = (p_region.base + p_region.size - 1) & ~granule_mask;
+  rlar |= static_cast<std::uint32_t>(p_region.type) << 1U;
+  rlar |= 1U;  // Region enable
+
+  return { .rbar = rbar, .rasr_or_rlar = rlar };
+}
+
+/**
+ * @brief MPU region register values encoded at compile time
+ *
+ * @tparam region_count - number of regions in the table
+ */
+template<std::size_t region_count>
+struct mpu_table
+{
+  /// The MPU architecture the regions were encoded for
+  mpu_architecture architecture;
+  /// Encoded regions, region N of the MPU is programmed with entry N
+  std::array<mpu_region_registers, region_count> regions;
+};
+
+/**
+ * @brief Encode a table of regions for the MPU at compile time
+ *
+ * Fails to compile if any region does not meet the requirements of the MPU
+ * architecture.
+ *
+ * Regions with a higher index take priority over lower regions where they
+ * overlap. A typical table looks like this:
+ *
+ *     constexpr auto mpu_regions = hal::cortex_m::make_mpu_table(std::array{
+ *       // Flash: write-back, write allocate
+ *       mpu_region{ .base = 0x0800'0000, .size = 2 * 1024 * 1024,
+ *                   .access = mpu_access::read_only },
+ *       // SRAM: write-back, write allocate
+ *       mpu_region{ .base = 0x2400'0000, .size = 512 * 1024,
+ *                   .execute_never = true },
+ *       // DMA ring buffers: non-cacheable
+ *       mpu_region{ .base = 0x2407'0000, .size = 64 * 1024,
+ *                   .type = mpu_memory_type::normal_non_cacheable,
+ *                   .shareable = true, .execute_never = true },
+ *     });
+ *
+ *     hal::cortex_m::configure_mpu(mpu_regions);
+ *
+ * @tparam region_count - number of regions in the table
+ * @tparam architecture - MPU architecture to encode the table for
+ * @param p_regions - regions to encode
+ * @return consteval mpu_table<region_count> - encoded regions
+ */
+template<mpu_architecture architecture = native_mpu_architecture,
+         std::size_t region_count>
+consteval mpu_table<region_count> make_mpu_table(
+  std::array<mpu_region, region_count> const& p_regions)
+{
+  mpu_table<region_count> table{ .architecture = architecture, .regions = {} };
+  for (std::size_t i = 0; i < region_count; i++) {
+    if constexpr (architecture == mpu_architecture::armv8m) {
+      table.regions[i] = encode_armv8m_mpu_region(p_regions[i]);
+    } else {
+      table.regions[i] = encode_armv7m_mpu_region(p_regions[i]);
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief Get the number of regions supported by the MPU
+ *
+ * @return std::uint8_t - number of regions, 0 if the device has no MPU
+ */
+[[nodiscard]] std::uint8_t mpu_region_count();
+
+/**
+ * @brief Program and enable the MPU
+ *
+ * Using this function directly is not recommended. Use the mpu_table overload
+ * instead.
+ *
+ * The MPU is disabled while the regions are programmed. Every region beyond
+ * the end of the table is disabled. The MPU is then enabled, with the default
+ * memory map acting as a background region for privileged code if
+ * p_privileged_default_map is true.
+ *
+ * @param p_regions - encoded regions. Must not contain more entries than
+ * mpu_region_count() returns.
+ * @param p_architecture - the MPU architecture the regions were encoded for
+ * @param p_privileged_default_map - enable the default memory map for
+ * privileged accesses that do not hit any region
+ * @throws hal::argument_out_of_domain - if there are more regions than the MPU
+ * supports or the architecture does not match the processor.
+ */
+void configure_mpu(std::span<mpu_region_registers const> p_regions,
+                   mpu_architecture p_architecture,
+                   bool p_privileged_default_map = true);
+
+/**
+ * @brief Program and enable the MPU from a table encoded at compile time
+ *
+ * @tparam region_count - number of regions in the table
+ * @param p_table - table created by `make_mpu_table()`
+ * @param p_privileged_default_map - enable the default memory map for
+ * privileged accesses that do not hit any region
+ */
+template<std::size_t region_count>
+inline void configure_mpu(mpu_table<region_count> const& p_table,
+                          bool p_privileged_default_map = true)
+{
+  configure_mpu(
+    p_table.regions, p_table.architecture, p_privileged_default_map);
+}
+
+/**
+ * @brief Disable the MPU
+ *
+ * All accesses use the default memory map after this call.
+ */
+void disable_mpu();
+}  // namespace hal::cortex_m
@@ -0,0 +1,197 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <libhal-armcortex/system_control.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief Make prior writes visible to every core, then wake every core
+ *
+ * Completes all outstanding memory accesses with DSB before executing SEV, so
+ * that a core woken from WFE observes the data which it was woken for.
+ *
+ */
+void signal_cores();
+
+/**
+ * @brief Notifies a core that work is available
+ *
+ * The doorbell allows one core to hand work to another without the waiting
+ * core spin-polling shared memory. The waiting core sleeps in WFE until the
+ * other core rings the doorbell with SEV. Rings that happen before the waiting
+ * core gets to `wait()` are not lost, and multiple rings before a `wait()`
+ * coalesce into one.
+ *
+ * A doorbell has a single ringing core and a single answering core. It only
+ * uses atomic loads and stores, so it is lock-free on ARMv6-M and ARMv7-M
+ * alike. The doorbell must reside in memory shared by both cores which is not
+ * cached, such as RP2040 SRAM or STM32H7 D3 SRAM marked non-cacheable by the
+ * MPU.
+ */
+class core_doorbell
+{
+public:
+  /**
+   * @brief Ring the doorbell
+   *
+   * Must only be called by the ringing core. Writes made before this call are
+   * visible to the answering core once it returns from `wait()`.
+   */
+  void ring();
+
+  /**
+   * @brief Answer the doorbell if it has been rung
+   *
+   * Must only be called by the answering core.
+   *
+   * @return true - if the doorbell has been rung since it was last answered
+   */
+  [[nodiscard]] bool answer();
+
+  /**
+   * @brief Sleep until the doorbell has been rung, then answer it
+   *
+   * Must only be called by the answering core.
+   */
+  void wait();
+
+private:
+  std::atomic<std::uint32_t> m_rings = 0;
+  std::uint32_t m_answered = 0;
+};
+
+/**
+ * @brief Bounded single producer, single consumer queue between two cores
+ *
+ * The producing core pushes messages with `try_send()` and `send()`, the
+ * consuming core pops them with `try_receive()` and `receive()`. Each side
+ * owns one index and only reads the other's, so the mailbox only uses atomic
+ * loads and stores and is lock-free on every Cortex M. Every send and receive
+ * is followed by `signal_cores()`, such that `receive()` waiting for a message
+ * and `send()` waiting for space sleep in WFE rather than spin.
+ *
+ * Like `core_doorbell`, the mailbox must reside in memory shared by both cores
+ * which is not cached.
+ *
+ * @tparam T - type of the messages, must be trivially copyable
+ * @tparam capacity - number of messages that can be waiting at once, must be
+ * a power of two.
+ */
+template<typename T, std::size_t capacity>
+class core_mailbox
+{
+public:
+  static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+                "The capacity of a core_mailbox must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Messages of a core_mailbox must be trivially copyable");
+
+  /**
+   * @brief Send a message if there is space for it
+   *
+   * Must only be called by the producing core.
+   *
+   * @param p_message - message to send
+   * @return true - if the message was sent
+   * @return false - if the mailbox is full
+   */
+  [[nodiscard]] bool try_send(T const& p_message)
+  {
+    auto const head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == capacity) {
+      return false;
+    }
+    m_messages[head & (capacity - 1)] = p_message;
+    m_head.store(head + 1, std::memory_order_release);
+    signal_cores();
+    return true;
+  }
+
+  /**
+   * @brief Send a message, sleeping until there is space for it
+   *
+   * Must only be called by the producing core.
+   *
+   * @param p_message - message to send
+   */
+  void send(T const& p_message)
+  {
+    while (not try_send(p_message)) {
+      wait_for_event();
+    }
+  }
+
+  /**
+   * @brief Receive a message if one is waiting
+   *
+   * Must only be called by the consuming core.
+   *
+   * @param p_message - destination of the message
+   * @return true - if a message was received into p_message
+   * @return false - if the mailbox is empty
+   */
+  [[nodiscard]] bool try_receive(T& p_message)
+  {
+    auto const tail = m_tail.load(std::memory_order_relaxed);
+    if (m_head.load(std::memory_order_acquire) == tail) {
+      return false;
+    }
+    p_message = m_messages[tail & (capacity - 1)];
+    m_tail.store(tail + 1, std::memory_order_release);
+    signal_cores();
+    return true;
+  }
+
+  /**
+   * @brief Receive a message, sleeping until one is waiting
+   *
+   * Must only be called by the consuming core.
+   *
+   * @return T - the oldest message of the mailbox
+   */
+  [[nodiscard]] T receive()
+  {
+    T message{};
+    while (not try_receive(message)) {
+      wait_for_event();
+    }
+    return message;
+  }
+
+  /**
+   * @brief Get the number of messages waiting
+   *
+   * @return std::size_t - number of messages waiting, may be out of date by
+   * the time it returns if the other core is using the mailbox.
+   */
+  [[nodiscard]] std::size_t size() const
+  {
+    return m_head.load(std::memory_order_acquire) -
+           m_tail.load(std::memory_order_acquire);
+  }
+
+private:
+  std::atomic<std::uint32_t> m_head = 0;
+  std::atomic<std::uint32_t> m_tail = 0;
+  std::array<T, capacity> m_messages{};
+};
+}  // namespace hal::cortex_m
@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <span>
+
+#include <libhal-armcortex/system_control.hpp>
 
 // These need to be supplied by the linker script if the application developer
 // in order to call hal::cortex::initialize_data_section()
@@ -48,9 +52,225 @@ extern "C"
    *
    */
   extern uint32_t __bss_size;
+  /**
+   * @brief this symbol is placed at the top of the main stack, the end of RAM
+   *
+   */
+  extern uint32_t __stack;
+  /**
+   * @brief this symbol is placed at the lowest address of the main stack,
+   * `__stack_size` bytes below `__stack`.
+   *
+   */
+  extern uint32_t __stack_limit;
 }
 
 namespace hal::cortex_m {
+/**
+ * @brief An entry of the startup copy table
+ *
+ * Describes a region that is copied from ROM to RAM at startup. The layout
+ * must match the `{start, source, size}` triples emitted by the linker script.
+ */
+struct copy_region
+{
+  /// Start address of the region in RAM
+  std::uint32_t* start;
+  /// Start address of the region's contents in ROM
+  std::uint32_t const* source;
+  /// Number of bytes to copy
+  std::uint32_t size;
+};
+
+/**
+ * @brief An entry of the startup zero table
+ *
+ * Describes a region that is filled with zeros at startup. The layout must
+ * match the `{start, size, flags}` triples emitted by the linker script.
+ */
+struct zero_region
+{
+  /// Set in `flags` to skip zeroing this region when using startup_mode::lazy.
+  /// Use this for regions, such as backup RAM, which should survive a reset.
+  static constexpr std::uint32_t preserve = 1 << 0;
+
+  /// Start address of the region in RAM
+  std::uint32_t* start;
+  /// Number of bytes to zero
+  std::uint32_t size;
+  /// Bitwise OR of the flags above
+  std::uint32_t flags;
+};
+
+/**
+ * @brief Determines which regions of the zero table are zeroed at startup
+ *
+ * The zero table of the standard linker scripts only contains `.dtcm_bss`,
+ * which is never marked with `zero_region::preserve`, and the `.preserve`
+ * section is never zeroed in either mode. Thus startup_mode::lazy only has an
+ * effect on zero table entries added by the platform with the preserve flag
+ * set.
+ */
+enum class startup_mode : std::uint8_t
+{
+  /// Zero every region in the zero table
+  cold = 0,
+  /// Skip regions marked with `zero_region::preserve`
+  lazy = 1,
+};
+}  // namespace hal::cortex_m
+
+// Copy and zero tables generated by libhal-armcortex/standard.ld
+extern "C"
+{
+  /**
+   * @brief Start of the table of regions to copy from ROM to RAM
+   *
+   */
+  extern hal::cortex_m::copy_region const __copy_table_start[];
+  /**
+   * @brief End of the table of regions to copy from ROM to RAM
+   *
+   */
+  extern hal::cortex_m::copy_region const __copy_table_end[];
+  /**
+   * @brief Start of the table of regions to fill with zeros
+   *
+   */
+  extern hal::cortex_m::zero_region const __zero_table_start[];
+  /**
+   * @brief End of the table of regions to fill with zeros
+   *
+   */
+  extern hal::cortex_m::zero_region const __zero_table_end[];
+}
+
+namespace hal::cortex_m {
+/**
+ * @brief Copy a region from ROM to RAM
+ *
+ * Copies 16 bytes per iteration when both addresses are word aligned, which
+ * the linker script guarantees for its own regions. This allows the compiler
+ * to use `ldm`/`stm` burst transfers. Unaligned regions fall back to memcpy.
+ *
+ * @param p_region - region to copy
+ */
+inline void copy_section(copy_region const& p_region)
+{
+  auto* destination = p_region.start;
+  auto const* source = p_region.source;
+  auto size = p_region.size;
+
+  constexpr auto word_alignment = sizeof(std::uint32_t) - 1;
+  auto const addresses = reinterpret_cast<std::uintptr_t>(destination) |
+                         reinterpret_cast<std::uintptr_t>(source);
+
+  if ((addresses & word_alignment) != 0) {
+    memcpy(destination, source, size);
+    return;
+  }
+
+  // Kept in std::uint32_t, the type of size, for -Wconversion clean arithmetic
+  constexpr std::uint32_t word_size = sizeof(std::uint32_t);
+  constexpr std::uint32_t burst_size = 4 * word_size;
+  for (; size >= burst_size; size -= burst_size) {
+    auto const word0 = source[0];
+    auto const word1 = source[1];
+    auto const word2 = source[2];
+    auto const word3 = source[3];
+    destination[0] = word0;
+    destination[1] = word1;
+    destination[2] = word2;
+    destination[3] = word3;
+    destination += 4;
+    source += 4;
+  }
+
+  for (; size >= word_size; size -= word_size) {
+    *destination++ = *source++;
+  }
+
+  // Copy remaining bytes of regions whose size is not a multiple of 4
+  memcpy(destination, source, size);
+}
+
+/**
+ * @brief Fill words of memory with a value
+ *
+ * Writes 16 bytes per iteration, allowing the compiler to use `stm` burst
+ * transfers. Always inlined so that it can paint the stack it runs on.
+ *
+ * @param p_words - words to fill
+ * @param p_value - value written to each word
+ */
+[[gnu::always_inline]] inline void fill_words(std::span<std::uint32_t> p_words,
+                                              std::uint32_t p_value)
+{
+  auto* destination = p_words.data();
+  auto count = p_words.size();
+
+  for (; count >= 4; count -= 4) {
+    destination[0] = p_value;
+    destination[1] = p_value;
+    destination[2] = p_value;
+    destination[3] = p_value;
+    destination += 4;
+  }
+
+  for (; count > 0; count--) {
+    *destination++ = p_value;
+  }
+}
+
+/**
+ * @brief Fill a region with zeros
+ *
+ * Writes 16 bytes per iteration when the region is word aligned. Unaligned
+ * regions fall back to memset.
+ *
+ * @param p_region - region to zero
+ */
+inline void zero_section(zero_region const& p_region)
+{
+  auto* destination = p_region.start;
+  auto size = p_region.size;
+
+  constexpr auto word_alignment = sizeof(std::uint32_t) - 1;
+  if ((reinterpret_cast<std::uintptr_t>(destination) & word_alignment) != 0) {
+    memset(destination, 0, size);
+    return;
+  }
+
+  auto const words = size / sizeof(std::uint32_t);
+  fill_words({ destination, words }, 0);
+
+  memset(destination + words, 0, size % sizeof(std::uint32_t));
+}
+
+/**
+ * @brief Copy and zero each region of a startup table
+ *
+ * @param p_copy_table - regions to copy from ROM to RAM
+ * @param p_zero_table - regions to fill with zeros
+ * @param p_mode - lazy mode skips zero regions with the preserve flag set
+ */
+inline void initialize_sections(std::span<copy_region const> p_copy_table,
+                                std::span<zero_region const> p_zero_table,
+                                startup_mode p_mode = startup_mode::cold)
+{
+  for (auto const& region : p_copy_table) {
+    copy_section(region);
+  }
+
+  for (auto const& region : p_zero_table) {
+    bool const preserved = (region.flags & zero_region::preserve) != 0U;
+    if (p_mode == startup_mode::lazy && preserved) {
+      continue;
+    }
+    zero_section(region);
+  }
+}
+
 /**
  * @brief Initialize the data section of RAM. This should be the first thing
  * called in main() before using any global or statically allocated variables.
@@ -65,14 +285,43 @@ namespace hal::cortex_m {
  * haven't been loaded by any means and should set the data section at the start
  * of the application.
  *
+ * This walks the copy and zero tables generated by the linker script, which
+ * also initializes the tightly coupled memory sections that crt0 knows
+ * nothing about:
+ *
+ * - `.itcm_text` code is copied from ROM. Place hot interrupt service routines
+ *   here with `[[gnu::section(".itcm_text")]]`.
+ * - `.dtcm_data` data is copied from ROM. Place data here with
+ *   `[[gnu::section(".dtcm_data")]]`.
+ * - `.dtcm_bss` data is zeroed. Place zero initialized data here with
+ *   `__attribute__((section(".bss.dtcm")))`. The `.bss.` prefix makes the
+ *   compiler emit a NOBITS section that takes no space in the image, and
+ *   linker scripts without a `.dtcm_bss` section place it in `.bss`.
+ *
+ * These sections are located in ITCM and DTCM when the application uses
+ * `libhal-armcortex/tcm.ld` and in RAM otherwise. Platforms can add their own
+ * regions, such as additional SRAM banks, by placing `copy_region` and
+ * `zero_region` objects into `.copy_table.*` and `.zero_table.*` sections.
+ *
+ * @param p_mode - use startup_mode::lazy to skip zeroing regions marked with
+ * `zero_region::preserve`. Only platform added regions can be marked, see
+ * startup_mode.
  */
-inline void initialize_data_section()
+inline void initialize_data_section(startup_mode p_mode = startup_mode::cold)
 {
   // Initialize statically allocated data by coping the data section from ROM to
   // RAM. CRT0.o/.s does not perform .data section initialization so it must be
   // done by initialize_platform.
-  intptr_t data_size = reinterpret_cast<intptr_t>(&__data_size);
-  memcpy(&__data_start, &__data_source, data_size);
+  initialize_sections({ __copy_table_start, __copy_table_end },
+                      { __zero_table_start, __zero_table_end },
+                      p_mode);
+
+#if defined(__arm__)
+  // Ensure the code copied into ITCM is visible to instruction fetches before
+  // any of it is executed.
+  asm volatile("dsb" : : : "memory");
+  asm volatile("isb" : : : "memory");
+#endif
 }
 /**
  * @brief Initialize the BSS (uninitialized data section) to all zeros.
@@ -84,7 +333,109 @@ inline void initialize_bss_section()
   // Initialize statically allocated data by coping the data section from ROM to
   // RAM. CRT0.o/.s does not perform .data section initialization so it must be
   // done by initialize_platform.
-  intptr_t bss_size = reinterpret_cast<intptr_t>(&__bss_size);
-  memset(&__bss_start, 0, bss_size);
+  auto const bss_size = reinterpret_cast<std::uintptr_t>(&__bss_size);
+  zero_section({ .start = &__bss_start,
+                 .size = static_cast<std::uint32_t>(bss_size),
+                 .flags = 0 });
+}
+
+/// Value written to each word of a painted stack
+inline constexpr std::uint32_t stack_paint_pattern = 0xA5A5'A5A5;
+
+/// Bytes below the stack pointer left unpainted by paint_main_stack()
+inline constexpr std::uint32_t main_stack_paint_margin = 128;
+
+/**
+ * @brief Fill a stack with the paint pattern
+ *
+ * Paint a stack before it is used, then call stack_high_water_mark() to
+ * measure how much of it has been used since.
+ *
+ * @param p_stack - stack to paint, must not be in use
+ */
+inline void paint_stack(std::span<std::uint32_t> p_stack)
+{
+  fill_words(p_stack, stack_paint_pattern);
+}
+
+/**
+ * @brief Get the most bytes of a painted stack used so far
+ *
+ * Stacks grow down, so the words at the bottom of the stack which still hold
+ * the paint pattern have never been used. The result is exact unless the
+ * deepest used word happens to hold the pattern.
+ *
+ * @param p_stack - stack previously painted with paint_stack()
+ * @return std::size_t - number of bytes, from the top of the stack, that have
+ * been written since the stack was painted.
+ */
+[[nodiscard]] inline std::size_t stack_high_water_mark(
+  std::span<std::uint32_t const> p_stack)
+{
+  std::size_t unused = 0;
+  while (unused < p_stack.size() && p_stack[unused] == stack_paint_pattern) {
+    unused++;
+  }
+  return (p_stack.size() - unused) * sizeof(std::uint32_t);
+}
+
+/**
+ * @brief Get the main stack reserved by the linker script
+ *
+ * @return std::span<std::uint32_t> - words from `__stack_limit` to `__stack`
+ */
+inline std::span<std::uint32_t> main_stack()
+{
+  return { &__stack_limit, &__stack };
+}
+
+/**
+ * @brief Paint the unused part of the main stack
+ *
+ * Paints from the bottom of the main stack up to `main_stack_paint_margin`
+ * bytes below the current stack pointer. Call this as early as possible in
+ * main(), such as right after initialize_data_section(), as the stack used
+ * until this point is counted as used.
+ *
+ * Does nothing in host builds.
+ */
+[[gnu::always_inline]] inline void paint_main_stack()
+{
+#if defined(__arm__)
+  std::uintptr_t stack_pointer = 0;
+  asm volatile("mov %0, sp" : "=r"(stack_pointer));
+
+  auto const bottom = reinterpret_cast<std::uintptr_t>(&__stack_limit);
+  auto const end = stack_pointer - main_stack_paint_margin;
+  if (end <= bottom) {
+    return;
+  }
+  fill_words({ &__stack_limit, (end - bottom) / sizeof(std::uint32_t) },
+             stack_paint_pattern);
+#endif
+}
+
+/**
+ * @brief Get the most bytes of the main stack used since it was painted
+ *
+ * PRECONDITION: paint_main_stack() has been called.
+ *
+ * @return std::size_t - high-water mark of the main stack in bytes
+ */
+[[nodiscard]] inline std::size_t main_stack_high_water_mark()
+{
+  return stack_high_water_mark(main_stack());
+}
+
+/**
+ * @brief Fault on overflow of the main stack
+ *
+ * Sets the main stack limit to `__stack_limit`, so that an overflow raises a
+ * UsageFault instead of corrupting the heap. Does nothing on devices without
+ * stack limit registers, see stack_limit_supported().
+ */
+inline void guard_main_stack()
+{
+  set_main_stack_limit(&__stack_limit);
 }
-}  // namespace hal::cortex_m
\ No newline at end of file
+}  // namespace hal::cortex_m
@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <cstdint>
+#include <span>
+
+#include <libhal/units.hpp>
+
 /**
  * @brief libhal drivers for the ARM Cortex-M series of processors
  *
@@ -29,6 +34,170 @@ namespace hal::cortex_m {
  */
 void initialize_floating_point_unit();
 
+/**
+ * @brief How exceptions preserve the floating point state of the code they
+ * preempt
+ *
+ */
+enum class floating_point_stacking : std::uint8_t
+{
+  /// Space for s0-s15 & FPSCR is reserved on exception entry, but they are
+  /// only saved if the exception executes a floating point instruction. This
+  /// is the reset behavior.
+  lazy,
+  /// s0-s15 & FPSCR are saved on entry to every exception that preempts code
+  /// which has used floating point.
+  always,
+  /// Floating point state is never saved automatically. Exception frames are
+  /// never extended, so no exception may use floating point unless it saves
+  /// the registers itself. Context switching cannot preserve the floating
+  /// point registers of tasks in this mode.
+  none,
+};
+
+/**
+ * @brief Select how exceptions preserve the floating point state
+ *
+ * Does nothing useful on devices without a floating point unit.
+ *
+ * @param p_stacking - the stacking behavior
+ */
+void set_floating_point_stacking(floating_point_stacking p_stacking);
+
+/**
+ * @brief Get how exceptions preserve the floating point state
+ *
+ * @return floating_point_stacking - the current stacking behavior
+ */
+[[nodiscard]] floating_point_stacking get_floating_point_stacking();
+
+/**
+ * @brief Determine if the exception frame is extended with floating point
+ * state
+ *
+ * Bit 4 of EXC_RETURN is cleared when the frame of the preempted code includes
+ * space for s0-s15 & FPSCR, adding 18 words to the 8 word basic frame.
+ *
+ * The link register only holds EXC_RETURN on entry to a handler installed
+ * directly in the vector table. Handlers behind `static_callable`, the irq
+ * dispatch or the instrumented dispatcher see a return address instead, and
+ * the compiler is free to reuse the link register before any C++ code runs.
+ * Capture EXC_RETURN in a naked handler, as `fault_capture_handler()` does, and
+ * pass it in.
+ *
+ * @param p_exc_return - the EXC_RETURN value found in the link register on
+ * exception entry
+ * @return true - if the frame is extended
+ */
+[[nodiscard]] constexpr bool is_extended_exception_frame(
+  std::uint32_t p_exc_return)
+{
+  return (p_exc_return & (1U << 4)) == 0U;
+}
+
+/**
+ * @brief Determine if a floating point save is still pending
+ *
+ * Within an exception using lazy stacking, this is true while space for the
+ * preempted code's floating point state is reserved but has not been written,
+ * that is, until the exception executes its first floating point instruction.
+ *
+ * @return true - if lazy state preservation is active
+ */
+[[nodiscard]] bool lazy_floating_point_save_pending();
+
+/**
+ * @brief Enable the L1 instruction cache
+ *
+ * The cache is invalidated before it is enabled. Does nothing if the cache is
+ * already enabled.
+ *
+ * Caches are only found on Cortex M7 and some ARMv8-M mainline processors.
+ * Calling this on a processor without an instruction cache has no effect.
+ *
+ */
+void enable_instruction_cache();
+
+/**
+ * @brief Disable the L1 instruction cache
+ *
+ */
+void disable_instruction_cache();
+
+/**
+ * @brief Enable the L1 data cache
+ *
+ * The cache is invalidated before it is enabled. Does nothing if the cache is
+ * already enabled.
+ *
+ * Caches are only found on Cortex M7 and some ARMv8-M mainline processors.
+ * Calling this on a processor without a data cache has no effect.
+ *
+ */
+void enable_data_cache();
+
+/**
+ * @brief Disable the L1 data cache
+ *
+ * Dirty cache lines are written back to memory before the cache is disabled.
+ *
+ */
+void disable_data_cache();
+
+/**
+ * @brief Write back dirty data cache lines covering a region of memory
+ *
+ * Use this before a DMA peripheral reads memory written by the CPU. The region
+ * is expanded to cache line boundaries. Regions larger than the data cache are
+ * cleaned by set/way which is faster than cleaning each line of the region.
+ *
+ * @param p_memory - region of memory to clean
+ */
+void clean_dcache(std::span<hal::byte const> p_memory);
+
+/**
+ * @brief Discard data cache lines covering a region of memory
+ *
+ * Use this after a DMA peripheral writes memory that will be read by the CPU.
+ * Ideally the region should start and end on a cache line boundary. If it does
+ * not, the partially covered lines at the edges are cleaned and invalidated
+ * so data outside of the region sharing those lines is not lost. Regions
+ * larger than the data cache clean and invalidate the entire cache as
+ * invalidating every line by set/way would discard unrelated dirty data.
+ *
+ * @param p_memory - region of memory to invalidate
+ */
+void invalidate_dcache(std::span<hal::byte> p_memory);
+
+/**
+ * @brief Write back then discard data cache lines covering a region of memory
+ *
+ * The region is expanded to cache line boundaries. Regions larger than the
+ * data cache are cleaned and invalidated by set/way.
+ *
+ * @param p_memory - region of memory to clean and invalidate
+ */
+void clean_invalidate_dcache(std::span<hal::byte> p_memory);
+
+/**
+ * @brief Executes the DSB instruction
+ *
+ * Completes all explicit memory accesses before any following instruction
+ * executes.
+ *
+ */
+void data_synchronization_barrier();
+
+/**
+ * @brief Executes the ISB instruction
+ *
+ * Flushes the pipeline so instructions following it are fetched again after
+ * the barrier completes. Required after changing system control state, such
+ * as the caches or MPU, that affects instruction fetches.
+ *
+ */
+void instruction_synchronization_barrier();
+
 /**
  * @brief Set the address of the systems interrupt vector table
  *
@@ -89,4 +258,46 @@ void wait_for_interrupt();
  *
  */
 void wait_for_event();
+
+/**
+ * @brief Executes SEV instruction
+ *
+ * The SEV instruction sets the event register of every core of the system,
+ * waking any core waiting in WFE and causing the next WFE to return at once.
+ *
+ */
+void send_event();
+
+/**
+ * @brief Determine if the device has stack limit registers
+ *
+ * ARMv8-M devices have the MSPLIM and PSPLIM registers, which raise a
+ * UsageFault when the main or process stack pointer would drop below them.
+ *
+ * @return true - if the stack limit functions below configure the hardware
+ */
+[[nodiscard]] bool stack_limit_supported();
+
+/**
+ * @brief Set the lowest address the main stack may grow down to
+ *
+ * Writes MSPLIM on ARMv8-M and does nothing on other devices. Stack overflow
+ * is then caught before the stack corrupts the memory below it. ARMv8-M
+ * baseline devices only implement the limit in the secure state.
+ *
+ * @param p_limit - lowest address of the main stack, aligned to 8 bytes.
+ * Pass nullptr to disable the check.
+ */
+void set_main_stack_limit(void const* p_limit);
+
+/**
+ * @brief Set the lowest address the process stack may grow down to
+ *
+ * Writes PSPLIM on ARMv8-M and does nothing on other devices. The context
+ * switch handler sets this for each task.
+ *
+ * @param p_limit - lowest address of the process stack, aligned to 8 bytes.
+ * Pass nullptr to disable the check.
+ */
+void set_process_stack_limit(void const* p_limit);
 }  // namespace hal::cortex_m
@@ -0,0 +1,121 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <libhal-armcortex/frequency_scale.hpp>
+#include <libhal-armcortex/systick_timer.hpp>
+#include <libhal/functional.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/timer.hpp>
+
+namespace hal::cortex_m {
+/**
+ * @brief A 64-bit steady clock and timer built on a single SysTick timer
+ *
+ * Available in all ARM Cortex M series processors, making it the steady clock
+ * of choice for Cortex M0, M0+ and M1 devices which lack a DWT cycle counter.
+ *
+ * SysTick counts down and the SysTick interrupt adds the length of every period
+ * to a 64-bit count of elapsed clock cycles. Reading the uptime combines the
+ * count with the current value and is safe to call with interrupts masked or
+ * from within another interrupt, as a wrap whose interrupt has not run yet is
+ * detected by the SysTick pending bit.
+ *
+ * The pending bit is cleared on entry to the SysTick interrupt, before the
+ * interrupt has accounted for the wrap. So that no interrupt reading the
+ * uptime can preempt it in between, the constructor sets the SysTick
+ * interrupt to the most urgent configurable priority, 0, which must not be
+ * changed. The uptime cannot be read from NMI or HardFault handlers, and
+ * callbacks scheduled on the timer run at this priority, so they should be
+ * short.
+ *
+ * The counter is also a hal::timer that shares the same interrupt. While
+ * nothing is scheduled, periods are the full 2^24 clock cycles. When a
+ * callback is scheduled, the length of the following periods is chosen so that
+ * a period ends on the deadline, and the interrupt calls the callback once the
+ * uptime reaches the deadline. A deadline that lands inside a long period that
+ * is already counting restarts the counter with a shorter period, which can
+ * lose the few clock cycles between reading and clearing the counter. Delays
+ * have no upper limit, allowing one systick_counter to drive a timer_queue as
+ * both its timer and its clock:
+ *
+ *     hal::cortex_m::systick_counter counter(48.0_MHz);
+ *     std::array<hal::cortex_m::timer_event*, 32> storage{};
+ *     hal::cortex_m::timer_queue queue(counter, counter, storage, 24h);
+ *
+ * The counter owns the SysTick timer and its interrupt, thus cannot be used at
+ * the same time as systick_timer.
+ */
+class systick_counter
+  : public hal::steady_clock
+  , public hal::timer
+{
+public:
+  /// Clock sources of the SysTick timer
+  using clock_source = systick_timer::clock_source;
+
+  /**
+   * @brief Construct and start a new systick_counter
+   *
+   * PRECONDITION: Interrupt vector table must be initialized before creating an
+   * instance of this object.
+   *
+   * @param p_frequency - the clock source's frequency
+   * @param p_source - the source of the clock to the systick timer
+   * @throws hal::operation_not_permitted - thrown when the precondition to
+   * initialize the interrupt vector table before constructing this object.
+   */
+  systick_counter(hertz p_frequency,
+                  clock_source p_source = clock_source::processor);
+
+  systick_counter(systick_counter const&) = delete;
+  systick_counter& operator=(systick_counter const&) = delete;
+  systick_counter(systick_counter&&) = delete;
+  systick_counter& operator=(systick_counter&&) = delete;
+
+  /**
+   * @brief Stop the counter and disable the SysTick interrupt
+   *
+   */
+  ~systick_counter();
+
+private:
+  std::uint64_t driver_uptime() override;
+  hal::hertz driver_frequency() override;
+  bool driver_is_running() override;
+  void driver_cancel() override;
+  void driver_schedule(hal::callback<void(void)> p_callback,
+                       hal::time_duration p_delay) override;
+
+  std::uint64_t uptime_locked();
+  void service_pending_wrap();
+  void end_period();
+  void program_period();
+  void handle_interrupt();
+
+  hal::callback<void(void)> m_callback{};
+  /// Clock cycles counted before the current period started
+  std::uint64_t m_elapsed = 0;
+  /// Uptime at which the scheduled callback is due
+  std::uint64_t m_deadline = 0;
+  /// Reload value that the current period started from
+  std::uint32_t m_reload = 0;
+  bool m_scheduled = false;
+  hertz m_frequency;
+  frequency_scale m_nanoseconds_to_cycles{};
+};
+}  // namespace hal::cortex_m
@@ -16,7 +16,9 @@
 
 #include <cstdint>
 
+#include <libhal-armcortex/frequency_scale.hpp>
 #include <libhal-util/units.hpp>
+#include <libhal/functional.hpp>
 #include <libhal/timer.hpp>
 
 namespace hal::cortex_m {
@@ -26,6 +28,12 @@ namespace hal::cortex_m {
  * Available in all ARM Cortex M series processors. Provides a generic and
  * simple timer for every platform using these processor.
  *
+ * SysTick has a 24-bit counter. Delays longer than a single reload period are
+ * split into equal length periods, with the callback called at the end of the
+ * last one. This allows delays up to the full range of hal::time_duration.
+ * Each period is the delay divided by the number of periods, rounded down, so
+ * the callback is called early by less than one clock cycle per period.
+ *
  */
 class systick_timer : public hal::timer
 {
@@ -75,6 +83,19 @@ public:
   void register_cpu_frequency(hertz p_frequency,
                               clock_source p_source = clock_source::processor);
 
+  /**
+   * @brief Inform the driver of the frequency of the external clock source
+   *
+   * When the timer runs from the processor clock, delays that need more than
+   * one full 24-bit reload period are counted with the external clock if that
+   * takes fewer interrupts. The external clock is usually a fraction of the
+   * processor clock, trading resolution for fewer wakeups on long delays.
+   *
+   * @param p_frequency - frequency of the external clock source. Set to 0 to
+   * always use the clock source supplied to the constructor.
+   */
+  void register_external_clock_frequency(hertz p_frequency);
+
   /**
    * @brief Destroy the system timer object
    *
@@ -88,6 +109,14 @@ private:
   void driver_schedule(hal::callback<void(void)> p_callback,
                        hal::time_duration p_delay) override;
 
+  void handle_interrupt();
+
+  hal::callback<void(void)> m_callback{};
+  std::uint64_t m_periods_remaining = 0;
   hertz m_frequency = 1'000'000.0f;
+  hertz m_external_frequency = 0.0f;
+  frequency_scale m_nanoseconds_to_cycles{};
+  frequency_scale m_external_nanoseconds_to_cycles{};
+  clock_source m_source = clock_source::processor;
 };
 }  // namespace hal::cortex_m
@@ -0,0 +1,191 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include <libhal-armcortex/frequency_scale.hpp>
+#include <libhal/functional.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/timer.hpp>
+#include <libhal/units.hpp>
+
+namespace hal::cortex_m {
+class timer_queue;
+
+/**
+ * @brief A callback that can be scheduled on a timer_queue
+ *
+ * The event holds the callback and its bookkeeping, thus the queue never
+ * allocates. The event must outlive its time in the queue.
+ */
+class timer_event
+{
+public:
+  /**
+   * @brief Construct a new timer event
+   *
+   * @param p_callback - function to call when the event expires. Called from
+   * the interrupt of the timer driving the queue.
+   */
+  explicit timer_event(hal::callback<void(void)> p_callback)
+    : m_callback(p_callback)
+  {
+  }
+
+  timer_event(timer_event const&) = delete;
+  timer_event& operator=(timer_event const&) = delete;
+  timer_event(timer_event&&) = delete;
+  timer_event& operator=(timer_event&&) = delete;
+
+  /**
+   * @brief Determine if the event is waiting in a queue
+   *
+   * @return true - if the event is scheduled and has not expired
+   */
+  [[nodiscard]] bool scheduled() const
+  {
+    return m_index != not_scheduled;
+  }
+
+private:
+  friend class timer_queue;
+
+  static constexpr auto not_scheduled = std::numeric_limits<std::size_t>::max();
+
+  hal::callback<void(void)> m_callback;
+  std::uint64_t m_deadline = 0;
+  std::size_t m_index = not_scheduled;
+};
+
+/**
+ * @brief Multiplexes many timeouts onto a single hardware timer
+ *
+ * Designed to allow a single systick_timer to service dozens of concurrent
+ * timeouts. Events are kept in a binary min-heap ordered by deadline, held in
+ * caller provided storage. Scheduling and cancelling an event is O(log n).
+ *
+ * The timer is only ever programmed for the nearest deadline, so there are no
+ * periodic ticks. When the timer fires, every expired event is removed and
+ * called within the same interrupt, each at a cost of O(log n), and the timer
+ * is programmed for the next deadline. Deadlines are absolute times of the
+ * steady clock, so rescheduling an event from its own callback does not drift.
+ *
+ * Example usage:
+ *
+ *     // systick_timer chains reload periods, so long delays are accepted
+ *     std::array<hal::cortex_m::timer_event*, 32> storage{};
+ *     hal::cortex_m::timer_queue queue(systick, dwt_counter, storage, 1h);
+ *     hal::cortex_m::timer_event timeout([]() { handle_timeout(); });
+ *     queue.schedule(timeout, 50ms);
+ *
+ * On devices without a DWT cycle counter, such as the Cortex M0 and M0+, a
+ * systick_counter provides both the timer and the clock:
+ *
+ *     hal::cortex_m::timer_queue queue(counter, counter, storage, 24h);
+ *
+ */
+class timer_queue
+{
+public:
+  /**
+   * @brief Construct a new timer queue
+   *
+   * @param p_timer - timer to drive the queue. The queue takes ownership of
+   * the timer's schedule.
+   * @param p_clock - clock used to measure deadlines
+   * @param p_storage - storage for the heap, determines the maximum number of
+   * events that can be scheduled at once.
+   * @param p_maximum_delay - longest delay that p_timer accepts. Deadlines
+   * further away are reached in multiple steps of this length.
+   */
+  timer_queue(hal::timer& p_timer,
+              hal::steady_clock& p_clock,
+              std::span<timer_event*> p_storage,
+              hal::time_duration p_maximum_delay);
+
+  timer_queue(timer_queue const&) = delete;
+  timer_queue& operator=(timer_queue const&) = delete;
+  timer_queue(timer_queue&&) = delete;
+  timer_queue& operator=(timer_queue&&) = delete;
+
+  /**
+   * @brief Cancel every event and stop the timer
+   *
+   */
+  ~timer_queue();
+
+  /**
+   * @brief Schedule an event to expire after a delay
+   *
+   * If the event is already scheduled, it is moved to the new deadline.
+   *
+   * @param p_event - event to schedule
+   * @param p_delay - time from now until the event's callback is called
+   * @throws hal::resource_unavailable_try_again - if the queue is full
+   */
+  void schedule(timer_event& p_event, hal::time_duration p_delay);
+
+  /**
+   * @brief Remove an event from the queue
+   *
+   * Does nothing if the event is not scheduled.
+   *
+   * @param p_event - event to cancel
+   */
+  void cancel(timer_event& p_event);
+
+  /**
+   * @brief Get the number of scheduled events
+   *
+   * @return std::size_t - number of scheduled events
+   */
+  [[nodiscard]] std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Get the time until the nearest deadline
+   *
+   * Use this to decide how deeply the system can sleep while idle.
+   *
+   * @return hal::time_duration - time until the next event expires, 0 if it
+   * has already expired or hal::time_duration::max() if no event is
+   * scheduled.
+   */
+  [[nodiscard]] hal::time_duration time_until_next();
+
+private:
+  void dispatch();
+  void program_timer();
+  void insert(timer_event& p_event);
+  void remove(std::size_t p_index);
+  void place(timer_event& p_event, std::size_t p_index);
+  void sift_up(std::size_t p_index);
+  void sift_down(std::size_t p_index);
+
+  hal::timer* m_timer;
+  hal::steady_clock* m_clock;
+  std::span<timer_event*> m_heap;
+  std::size_t m_size = 0;
+  frequency_scale m_nanoseconds_to_ticks{};
+  frequency_scale m_ticks_to_nanoseconds{};
+  std::uint64_t m_maximum_ticks = 0;
+};
+}  // namespace hal::cortex_m
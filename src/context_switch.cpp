@@ -0,0 +1,245 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/context_switch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-armcortex/system_control.hpp>
+#include <libhal/error.hpp>
+#include <libhal/functional.hpp>
+
+#include "system_controller_reg.hpp"
+
+namespace hal::cortex_m {
+namespace {
+/// Words pushed by the hardware on exception entry without floating point
+/// state: r0-r3, r12, lr, pc & xpsr
+constexpr std::size_t hardware_frame_words = 8;
+/// Words pushed by the hardware on exception entry with floating point state:
+/// r0-r3, r12, lr, pc, xpsr, s0-s15, FPSCR & a reserved word
+constexpr std::size_t extended_frame_words = 26;
+/// Word of padding the hardware may add to align the frame to 8 bytes
+constexpr std::size_t frame_padding_words = 1;
+/// Words pushed by the context switch handler: r4-r11 & EXC_RETURN
+constexpr std::size_t software_frame_words = 9;
+/// Words pushed by the context switch handler for floating point: s16-s31
+constexpr std::size_t floating_point_frame_words = 16;
+
+static_assert(bootstrap_stack_words ==
+                extended_frame_words + frame_padding_words +
+                  software_frame_words + floating_point_frame_words,
+              "The bootstrap stack must hold the largest frame pushed by the "
+              "first context switch.");
+
+/// Return to thread mode using the process stack without floating point state
+constexpr std::uint32_t exc_return_thread_psp = 0xFFFF'FFFD;
+/// Thumb state bit of the xPSR, which must always be set
+constexpr std::uint32_t xpsr_thumb = 1 << 24;
+/// Stack pointer select bit of the CONTROL register
+constexpr std::uint32_t control_spsel = 1 << 1;
+
+task_selector select_next_task{};
+task_context* running_task = nullptr;
+
+void task_returned()
+{
+  while (true) {
+    continue;
+  }
+}
+
+bool context_switching_supported()
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__) || not defined(__arm__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__)
+[[gnu::naked]] void context_switch_handler()
+{
+  // Bit 4 of EXC_RETURN is clear when the hardware stacked floating point
+  // state, in which case the callee saved floating point registers belong to
+  // the outgoing task as well.
+  asm volatile("mrs r0, psp\n"
+#if defined(__ARM_FP)
+               "tst lr, #0x10\n"
+               "it eq\n"
+               "vstmdbeq r0!, {s16-s31}\n"
+#endif
+               "stmdb r0!, {r4-r11, lr}\n"
+               "bl hal_cortex_m_switch_context\n"
+               "ldmia r0!, {r4-r11, lr}\n"
+#if defined(__ARM_FP)
+               "tst lr, #0x10\n"
+               "it eq\n"
+               "vldmiaeq r0!, {s16-s31}\n"
+#endif
+               "msr psp, r0\n"
+               "bx lr\n");
+}
+#else
+void context_switch_handler()
+{
+}
+#endif
+}  // namespace
+
+/**
+ * @brief Save the outgoing task and select the next one
+ *
+ * Called from the context switch handler with the stack pointer of the
+ * outgoing task after its registers were saved.
+ *
+ * @param p_stack_pointer - stack pointer of the outgoing task
+ * @return std::uint32_t* - stack pointer of the incoming task
+ */
+extern "C" std::uint32_t* hal_cortex_m_switch_context(
+  std::uint32_t* p_stack_pointer)
+{
+  critical_section lock;
+
+  if (running_task != nullptr) {
+    running_task->stack_pointer = p_stack_pointer;
+  }
+
+  running_task = &select_next_task(running_task);
+  set_process_stack_limit(running_task->stack_limit);
+  return running_task->stack_pointer;
+}
+
+void initialize_task(task_context& p_task,
+                     std::span<std::uint32_t> p_stack,
+                     void (*p_entry)(void* p_argument),
+                     void* p_argument)
+{
+  // The hardware requires the stack to be 8 byte aligned on exception return
+  auto const top = reinterpret_cast<std::uintptr_t>(p_stack.data() +
+                                                    p_stack.size()) &
+                   ~std::uintptr_t{ 0b111 };
+  auto const usable_words =
+    (top - reinterpret_cast<std::uintptr_t>(p_stack.data())) /
+    sizeof(std::uint32_t);
+
+  if (p_stack.data() == nullptr ||
+      usable_words < hardware_frame_words + software_frame_words) {
+    hal::safe_throw(hal::argument_out_of_domain(&p_task));
+  }
+
+  auto* const frame = reinterpret_cast<std::uint32_t*>(top) -
+                      (hardware_frame_words + software_frame_words);
+
+  // r4-r11 & EXC_RETURN restored by the context switch handler
+  for (std::size_t i = 0; i < software_frame_words - 1; i++) {
+    frame[i] = 0;
+  }
+  frame[software_frame_words - 1] = exc_return_thread_psp;
+
+  // r0-r3, r12, lr, pc & xpsr restored by the hardware
+  auto* const hardware_frame = frame + software_frame_words;
+  hardware_frame[0] = static_cast<std::uint32_t>(
+    reinterpret_cast<std::uintptr_t>(p_argument));
+  hardware_frame[1] = 0;
+  hardware_frame[2] = 0;
+  hardware_frame[3] = 0;
+  hardware_frame[4] = 0;
+  hardware_frame[5] = static_cast<std::uint32_t>(
+    reinterpret_cast<std::uintptr_t>(&task_returned));
+  // The exception return loads pc directly, so the thumb bit must be clear
+  hardware_frame[6] = static_cast<std::uint32_t>(
+                        reinterpret_cast<std::uintptr_t>(p_entry)) &
+                      ~std::uint32_t{ 1 };
+  hardware_frame[7] = xpsr_thumb;
+
+  // The registers saved by the context switch handler are not checked
+  // against the limit, so room for them is kept below it.
+  auto const limit = (reinterpret_cast<std::uintptr_t>(p_stack.data()) +
+                      ((software_frame_words + floating_point_frame_words) *
+                       sizeof(std::uint32_t)) +
+                      0b111) &
+                     ~std::uintptr_t{ 0b111 };
+
+  p_task.stack_pointer = frame;
+  p_task.stack_limit = reinterpret_cast<std::uint32_t const*>(limit);
+}
+
+void initialize_context_switching(task_selector p_select_next,
+                                  std::uint8_t p_priority)
+{
+  if (not interrupt_vector_table_initialized()) {
+    hal::safe_throw(hal::operation_not_permitted(nullptr));
+  }
+
+  if (not context_switching_supported()) {
+    hal::safe_throw(hal::operation_not_supported(nullptr));
+  }
+
+  disable_interrupt(irq::pend_sv);
+
+  select_next_task = p_select_next;
+  running_task = nullptr;
+
+  set_priority(irq::pend_sv, p_priority);
+  enable_interrupt(irq::pend_sv, context_switch_handler);
+}
+
+void start_context_switching()
+{
+#if defined(__arm__)
+  // The first switch saves the registers of this code onto the bootstrap
+  // stack. They are never restored. If this code has used floating point,
+  // the hardware pushes an extended frame before the handler saves its own
+  // registers.
+  alignas(8) static std::array<std::uint32_t, bootstrap_stack_words>
+    bootstrap_stack{};
+  auto* const bootstrap_top = bootstrap_stack.data() + bootstrap_stack.size();
+  std::uint32_t control = 0;
+  asm volatile("msr psp, %0" : : "r"(bootstrap_top) : "memory");
+  asm volatile("mrs %0, control" : "=r"(control) : : "memory");
+  control |= control_spsel;
+  asm volatile("msr control, %0" : : "r"(control) : "memory");
+  asm volatile("isb" : : : "memory");
+#endif
+
+  request_context_switch();
+
+  while (true) {
+    continue;
+  }
+}
+
+void request_context_switch()
+{
+  // Writing 0 to the other bits of ICSR has no effect
+  scb->icsr = interrupt_control_state::pend_sv_set.value<std::uint32_t>();
+#if defined(__arm__)
+  // Ensure the exception is taken before a yielding task continues
+  asm volatile("dsb" : : : "memory");
+  asm volatile("isb" : : : "memory");
+#endif
+}
+
+task_context* current_task()
+{
+  return running_task;
+}
+}  // namespace hal::cortex_m
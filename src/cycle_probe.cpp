@@ -0,0 +1,50 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/cycle_probe.hpp>
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace hal::cortex_m {
+namespace {
+std::array<cycle_record, cycle_probe_capacity> records{};
+std::size_t records_in_use = 0;
+cycle_record scratch_record{ .name = "(overflow)" };
+}  // namespace
+
+cycle_record& allocate_cycle_record(char const* p_name)
+{
+  if (records_in_use == records.size()) {
+    return scratch_record;
+  }
+
+  auto& record = records[records_in_use++];
+  record.name = p_name;
+  return record;
+}
+
+std::span<cycle_record const> cycle_records()
+{
+  return std::span(records).first(records_in_use);
+}
+
+void reset_cycle_records()
+{
+  for (auto& record : std::span(records).first(records_in_use)) {
+    record = cycle_record{ .name = record.name };
+  }
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,197 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/deferred_work.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal/error.hpp>
+#include <libhal/functional.hpp>
+
+#include "system_controller_reg.hpp"
+
+namespace hal::cortex_m {
+namespace {
+std::span<deferred_work_slot> queue_storage{};
+std::uint32_t queue_mask = 0;
+std::atomic<std::uint32_t> write_position = 0;
+/// Only accessed by the PendSV handler
+std::uint32_t read_position = 0;
+std::atomic<std::uint32_t> dropped_calls = 0;
+
+void pend_deferred_work()
+{
+  // Writing 0 to the other bits of ICSR has no effect
+  scb->icsr = interrupt_control_state::pend_sv_set.value<std::uint32_t>();
+}
+
+/**
+ * @brief Claim the write position for the calling context
+ *
+ * @param p_position - expected write position, updated to the current write
+ * position on failure.
+ * @return true - if the position was claimed
+ */
+bool claim_position(std::uint32_t& p_position)
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__) || not defined(__arm__)
+  return write_position.compare_exchange_weak(
+    p_position, p_position + 1, std::memory_order_relaxed);
+#else
+  // Without exclusive access instructions, read-modify-write atomics are
+  // library calls, so interrupts are masked for the exchange instead.
+  critical_section lock;
+  auto const current = write_position.load(std::memory_order_relaxed);
+  if (current != p_position) {
+    p_position = current;
+    return false;
+  }
+  write_position.store(p_position + 1, std::memory_order_relaxed);
+  return true;
+#endif
+}
+
+void count_dropped_call()
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__) || not defined(__arm__)
+  dropped_calls.fetch_add(1, std::memory_order_relaxed);
+#else
+  critical_section lock;
+  dropped_calls.store(dropped_calls.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+#endif
+}
+
+void call_callback(void* p_context)
+{
+  (*static_cast<hal::callback<void(void)>*>(p_context))();
+}
+
+bool next_call_ready()
+{
+  auto const& slot = queue_storage[read_position & queue_mask];
+  return slot.sequence.load(std::memory_order_acquire) == read_position + 1;
+}
+
+void run_deferred_work()
+{
+  // Limit each run to a single pass over the queue, so that interrupts
+  // deferring work faster than it can be run cannot starve thread mode.
+  for (std::size_t i = 0; i < queue_storage.size(); i++) {
+    auto& slot = queue_storage[read_position & queue_mask];
+    if (not next_call_ready()) {
+      // Either the queue is empty or the context that reserved this slot has
+      // been preempted before publishing it. That context pends PendSV again
+      // once the call is published.
+      return;
+    }
+
+    auto const call = slot.call;
+    // Release the slot before the call, such that the call can defer itself
+    slot.sequence.store(read_position + queue_mask + 1,
+                        std::memory_order_release);
+    read_position++;
+    call.function(call.context);
+  }
+
+  if (next_call_ready()) {
+    pend_deferred_work();
+  }
+}
+}  // namespace
+
+void initialize_deferred_work(std::span<deferred_work_slot> p_storage,
+                              std::uint8_t p_priority)
+{
+  if (not interrupt_vector_table_initialized()) {
+    hal::safe_throw(hal::operation_not_permitted(nullptr));
+  }
+
+  auto const size = p_storage.size();
+  if (size == 0 || (size & (size - 1)) != 0) {
+    hal::safe_throw(hal::argument_out_of_domain(nullptr));
+  }
+
+  disable_interrupt(irq::pend_sv);
+
+  for (std::size_t i = 0; i < size; i++) {
+    p_storage[i].sequence.store(static_cast<std::uint32_t>(i),
+                                std::memory_order_relaxed);
+  }
+
+  queue_storage = p_storage;
+  queue_mask = static_cast<std::uint32_t>(size - 1);
+  write_position.store(0, std::memory_order_relaxed);
+  read_position = 0;
+  dropped_calls.store(0, std::memory_order_relaxed);
+
+  set_priority(irq::pend_sv, p_priority);
+  enable_interrupt(irq::pend_sv, run_deferred_work);
+}
+
+bool defer(void (*p_function)(void*), void* p_context)
+{
+  if (queue_storage.empty()) {
+    count_dropped_call();
+    return false;
+  }
+
+  auto position = write_position.load(std::memory_order_relaxed);
+  deferred_work_slot* slot = nullptr;
+
+  while (slot == nullptr) {
+    auto& candidate = queue_storage[position & queue_mask];
+    auto const sequence = candidate.sequence.load(std::memory_order_acquire);
+    auto const difference = static_cast<std::int32_t>(sequence - position);
+
+    if (difference < 0) {
+      // The slot has not been read since the last lap, the queue is full
+      count_dropped_call();
+      return false;
+    }
+
+    if (difference > 0) {
+      // Another context claimed this position first
+      position = write_position.load(std::memory_order_relaxed);
+      continue;
+    }
+
+    if (claim_position(position)) {
+      slot = &candidate;
+    }
+  }
+
+  slot->call = { .function = p_function, .context = p_context };
+  slot->sequence.store(position + 1, std::memory_order_release);
+
+  pend_deferred_work();
+  return true;
+}
+
+bool defer(hal::callback<void(void)>& p_callback)
+{
+  return defer(call_callback, &p_callback);
+}
+
+std::uint32_t deferred_work_dropped()
+{
+  return dropped_calls.load(std::memory_order_relaxed);
+}
+}  // namespace hal::cortex_m
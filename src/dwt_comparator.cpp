@@ -0,0 +1,166 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/dwt_comparator.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "dwt_counter_reg.hpp"
+
+#include <libhal-util/bit.hpp>
+#include <libhal/error.hpp>
+
+namespace hal::cortex_m {
+namespace {
+/// Bit N is set when comparator N is allocated. ARMv7-M implements LDREX/STREX
+/// so this is lock free and safe to use from interrupts.
+std::atomic<std::uint32_t> comparators_in_use{ 0 };
+
+bool try_to_claim(std::uint8_t p_comparator)
+{
+  auto const bit = std::uint32_t{ 1 } << p_comparator;
+  return (comparators_in_use.fetch_or(bit) & bit) == 0U;
+}
+
+void release(std::uint8_t p_comparator)
+{
+  comparators_in_use.fetch_and(~(std::uint32_t{ 1 } << p_comparator));
+}
+
+void enable_debug_monitor()
+{
+  // Debug events raise the DebugMonitor exception when no debugger is halting
+  // the core.
+  core->demcr = (core->demcr | core_trace_enable | debug_monitor_enable);
+}
+
+void disable_comparator(std::uint8_t p_comparator)
+{
+  dwt_comparator(p_comparator)->function = 0;
+}
+
+bool read_and_clear_matched(std::uint8_t p_comparator)
+{
+  // MATCHED is cleared by reading the FUNCTION register
+  auto const function = dwt_comparator(p_comparator)->function;
+  return hal::bit_extract<dwt_function::matched>(function) != 0U;
+}
+}  // namespace
+
+std::uint8_t dwt_comparator_count()
+{
+  return static_cast<std::uint8_t>(
+    hal::bit_extract<dwt_control::number_of_comparators>(dwt->ctrl));
+}
+
+dwt_watchpoint::dwt_watchpoint(void const volatile* p_address,
+                               std::size_t p_size,
+                               dwt_access p_access)
+  : m_comparator(0)
+{
+  auto const address = reinterpret_cast<std::uintptr_t>(p_address);
+
+  if (not std::has_single_bit(p_size) || (address & (p_size - 1)) != 0) {
+    hal::safe_throw(hal::argument_out_of_domain(this));
+  }
+
+  // Search from the highest comparator down to keep comparator 0, the only
+  // comparator capable of cycle matching, free.
+  bool claimed = false;
+  for (auto i = dwt_comparator_count(); i > 0 && not claimed; i--) {
+    m_comparator = static_cast<std::uint8_t>(i - 1);
+    claimed = try_to_claim(m_comparator);
+  }
+
+  if (not claimed) {
+    hal::safe_throw(hal::device_or_resource_busy(this));
+  }
+
+  auto const ignored_bits =
+    static_cast<std::uint32_t>(std::countr_zero(p_size));
+  auto* comparator = dwt_comparator(m_comparator);
+
+  comparator->function = 0;
+  comparator->comp = static_cast<std::uint32_t>(address);
+  comparator->mask = ignored_bits;
+
+  // The number of implemented MASK bits is implementation defined. Bits that
+  // are not implemented read back as zero.
+  if (comparator->mask != ignored_bits) {
+    comparator->mask = 0;
+    release(m_comparator);
+    hal::safe_throw(hal::argument_out_of_domain(this));
+  }
+
+  enable_debug_monitor();
+  static_cast<void>(read_and_clear_matched(m_comparator));
+  comparator->function = static_cast<std::uint32_t>(p_access);
+}
+
+dwt_watchpoint::~dwt_watchpoint()
+{
+  disable_comparator(m_comparator);
+  release(m_comparator);
+}
+
+bool dwt_watchpoint::triggered()
+{
+  return read_and_clear_matched(m_comparator);
+}
+
+dwt_cycle_match::dwt_cycle_match(std::uint32_t p_cycle)
+{
+  if (dwt_comparator_count() == 0 ||
+      hal::bit_extract<dwt_control::no_cycle_counter>(dwt->ctrl)) {
+    hal::safe_throw(hal::operation_not_supported(this));
+  }
+
+  if (not try_to_claim(0)) {
+    hal::safe_throw(hal::device_or_resource_busy(this));
+  }
+
+  enable_debug_monitor();
+  dwt->ctrl = (dwt->ctrl | enable_cycle_count);
+  rearm(p_cycle);
+}
+
+dwt_cycle_match::~dwt_cycle_match()
+{
+  disable_comparator(0);
+  release(0);
+}
+
+void dwt_cycle_match::rearm(std::uint32_t p_cycle)
+{
+  auto* comparator = dwt_comparator(0);
+
+  comparator->function = 0;
+  comparator->comp = p_cycle;
+  comparator->mask = 0;
+  static_cast<void>(read_and_clear_matched(0));
+  comparator->function = hal::bit_value<std::uint32_t>(0)
+                           .set<dwt_function::cycle_match>()
+                           .insert<dwt_function::function>(
+                             dwt_function::cycle_count_watchpoint)
+                           .get();
+}
+
+bool dwt_cycle_match::triggered()
+{
+  return read_and_clear_matched(0);
+}
+}  // namespace hal::cortex_m
@@ -14,12 +14,16 @@
 
 #include <libhal-armcortex/dwt_counter.hpp>
 
+#include <libhal-armcortex/interrupt.hpp>
+
 #include "dwt_counter_reg.hpp"
 
 namespace hal::cortex_m {
 dwt_counter::dwt_counter(hertz p_cpu_frequency)
-  : m_cpu_frequency(p_cpu_frequency)
+  : m_cycle_count(&dwt->cyccnt)
 {
+  register_cpu_frequency(p_cpu_frequency);
+
   // Enable trace core
   core->demcr = (core->demcr | core_trace_enable);
 
@@ -33,11 +37,39 @@ dwt_counter::dwt_counter(hertz p_cpu_frequency)
 void dwt_counter::register_cpu_frequency(hertz p_cpu_frequency)
 {
   m_cpu_frequency = p_cpu_frequency;
+  m_cycles_to_nanoseconds =
+    frequency_scale::cycles_to_nanoseconds(p_cpu_frequency);
+  m_nanoseconds_to_cycles =
+    frequency_scale::nanoseconds_to_cycles(p_cpu_frequency);
+}
+
+std::uint64_t dwt_counter::uptime_ns()
+{
+  return m_cycles_to_nanoseconds.scale(now());
+}
+
+std::uint64_t dwt_counter::duration_to_cycles(
+  hal::time_duration p_duration) const
+{
+  if (p_duration.count() <= 0) {
+    return 0;
+  }
+  return m_nanoseconds_to_cycles.scale(
+    static_cast<std::uint64_t>(p_duration.count()));
+}
+
+std::uint64_t dwt_counter::now_with_interrupts_masked()
+{
+  critical_section lock;
+  std::uint32_t const count = *m_cycle_count;
+  auto const next = advance(m_state.load(std::memory_order_relaxed), count);
+  m_state.store(next, std::memory_order_relaxed);
+  return extend(next, count);
 }
 
 std::uint64_t dwt_counter::driver_uptime()
 {
-  return m_uptime.update(dwt->cyccnt);
+  return now();
 }
 
 hal::hertz dwt_counter::driver_frequency()
@@ -15,8 +15,10 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
+#include <libhal-util/bit.hpp>
 #include <libhal/steady_clock.hpp>
 
 namespace hal::cortex_m {
@@ -71,6 +73,20 @@ struct dwt_register_t
   uint32_t volatile function3;
 };
 
+/// Structure type to access a single DWT comparator. Comparator N is located
+/// at `&dwt->comp0 + (N * 4)`.
+struct dwt_comparator_registers_t
+{
+  /// Offset: 0x000 (R/W)  Comparator Register
+  uint32_t volatile comp;
+  /// Offset: 0x004 (R/W)  Mask Register
+  uint32_t volatile mask;
+  /// Offset: 0x008 (R/W)  Function Register
+  uint32_t volatile function;
+  /// Reserved
+  std::array<uint32_t, 1> reserved;
+};
+
 /// Structure type to access the Core Debug Register (CoreDebug)
 struct core_debug_registers_t
 {
@@ -98,6 +114,60 @@ inline constexpr unsigned core_trace_enable = 1 << 24U;
 /// Mask for turning on cycle counter.
 inline constexpr unsigned enable_cycle_count = 1 << 0;
 
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// DWT Control Register (CTRL).
+namespace dwt_control {
+/// When set to 1, CYCCNT counts processor clock cycles
+static constexpr auto cycle_count_enable = hal::bit_mask::from<0>();
+
+/// When set to 1, CPICNT counts additional cycles of multi-cycle instructions
+/// and instruction fetch stalls
+static constexpr auto cpi_count_enable = hal::bit_mask::from<17>();
+
+/// When set to 1, EXCCNT counts cycles spent in exception entry and exit
+static constexpr auto exception_count_enable = hal::bit_mask::from<18>();
+
+/// When set to 1, SLEEPCNT counts cycles spent sleeping
+static constexpr auto sleep_count_enable = hal::bit_mask::from<19>();
+
+/// When set to 1, LSUCNT counts additional cycles of load/store instructions
+static constexpr auto lsu_count_enable = hal::bit_mask::from<20>();
+
+/// When set to 1, FOLDCNT counts folded instructions
+static constexpr auto fold_count_enable = hal::bit_mask::from<21>();
+
+/// Reads as 1 when the profiling counters are not implemented
+static constexpr auto no_profile_counters = hal::bit_mask::from<24>();
+
+/// Reads as 1 when CYCCNT is not implemented
+static constexpr auto no_cycle_counter = hal::bit_mask::from<25>();
+
+/// Number of comparators implemented
+static constexpr auto number_of_comparators = hal::bit_mask::from<28, 31>();
+}  // namespace dwt_control
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// DWT Comparator Function Registers (FUNCTIONn).
+namespace dwt_function {
+/// Selects the action taken on a comparator match, 0 disables the comparator
+static constexpr auto function = hal::bit_mask::from<0, 3>();
+
+/// When set to 1 on comparator 0, COMP0 is compared against CYCCNT
+static constexpr auto cycle_match = hal::bit_mask::from<7>();
+
+/// When set to 1, COMPn is compared against data values
+static constexpr auto data_value_match = hal::bit_mask::from<8>();
+
+/// Reads as 1 when the comparator matched since the register was last read
+static constexpr auto matched = hal::bit_mask::from<24>();
+
+/// FUNCTION value that generates a watchpoint event on a CYCCNT match
+static constexpr std::uint32_t cycle_count_watchpoint = 0b0100;
+}  // namespace dwt_function
+
+/// Mask for enabling the DebugMonitor exception in DEMCR
+inline constexpr unsigned debug_monitor_enable = 1 << 16U;
+
 /// Address of the hardware DWT registers
 inline constexpr intptr_t dwt_address = 0xE0001000UL;
 
@@ -109,4 +179,17 @@ inline auto* dwt = reinterpret_cast<dwt_register_t*>(dwt_address);
 inline auto* core =
   reinterpret_cast<core_debug_registers_t*>(core_debug_address);
 
+/**
+ * @brief Get the registers of a DWT comparator
+ *
+ * @param p_index - comparator index, must be less than NUMCOMP
+ * @return dwt_comparator_registers_t* - the registers of the comparator
+ */
+inline dwt_comparator_registers_t* dwt_comparator(std::size_t p_index)
+{
+  auto const first = reinterpret_cast<std::uintptr_t>(&dwt->comp0);
+  auto const offset = p_index * sizeof(dwt_comparator_registers_t);
+  return reinterpret_cast<dwt_comparator_registers_t*>(first + offset);
+}
+
 }  // namespace hal::cortex_m
@@ -0,0 +1,128 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/dwt_profiler.hpp>
+
+#include <cstdint>
+
+#include "dwt_counter_reg.hpp"
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/bit.hpp>
+#include <libhal/error.hpp>
+
+namespace hal::cortex_m {
+namespace {
+struct raw_counts
+{
+  std::uint32_t cycles;
+  std::uint32_t cpi;
+  std::uint32_t exception;
+  std::uint32_t sleep;
+  std::uint32_t lsu;
+  std::uint32_t fold;
+};
+
+raw_counts read_counters()
+{
+  return raw_counts{
+    .cycles = dwt->cyccnt,
+    .cpi = dwt->cpicnt,
+    .exception = dwt->exccnt,
+    .sleep = dwt->sleepcnt,
+    .lsu = dwt->lsucnt,
+    .fold = dwt->foldcnt,
+  };
+}
+}  // namespace
+
+dwt_profiler::dwt_profiler(dwt_profiler_settings const& p_settings)
+{
+  if (hal::bit_extract<dwt_control::no_profile_counters>(dwt->ctrl) ||
+      hal::bit_extract<dwt_control::no_cycle_counter>(dwt->ctrl)) {
+    hal::safe_throw(hal::operation_not_permitted(this));
+  }
+
+  // Enable trace core
+  core->demcr = (core->demcr | core_trace_enable);
+
+  m_enabled_counters =
+    hal::bit_value<std::uint32_t>(0)
+      .insert<dwt_control::cpi_count_enable>(std::uint32_t{ p_settings.cpi })
+      .insert<dwt_control::exception_count_enable>(
+        std::uint32_t{ p_settings.exception })
+      .insert<dwt_control::sleep_count_enable>(
+        std::uint32_t{ p_settings.sleep })
+      .insert<dwt_control::lsu_count_enable>(std::uint32_t{ p_settings.lsu })
+      .insert<dwt_control::fold_count_enable>(std::uint32_t{ p_settings.fold })
+      .get();
+
+  // Start the event counters from a known state
+  dwt->cpicnt = 0;
+  dwt->exccnt = 0;
+  dwt->sleepcnt = 0;
+  dwt->lsucnt = 0;
+  dwt->foldcnt = 0;
+
+  dwt->ctrl = dwt->ctrl | m_enabled_counters |
+              dwt_control::cycle_count_enable.value<std::uint32_t>();
+
+  sample();
+}
+
+dwt_profiler::dwt_profiler()
+  : dwt_profiler(dwt_profiler_settings{})
+{
+}
+
+dwt_profiler::~dwt_profiler()
+{
+  dwt->ctrl = dwt->ctrl & ~m_enabled_counters;
+}
+
+dwt_snapshot dwt_profiler::snapshot()
+{
+  // The overflow counters are updated within the same lock as the read. An
+  // interrupt calling sample() in between would otherwise leave this thread
+  // applying an older count, which the overflow counters take to be a wrap.
+  critical_section lock;
+  auto const counts = read_counters();
+
+  dwt_snapshot result{ .cycles = m_cycles.update(counts.cycles) };
+
+  if (hal::bit_extract<dwt_control::cpi_count_enable>(m_enabled_counters)) {
+    result.cpi = m_cpi.update(counts.cpi & 0xFF);
+  }
+  if (hal::bit_extract<dwt_control::exception_count_enable>(
+        m_enabled_counters)) {
+    result.exception = m_exception.update(counts.exception & 0xFF);
+  }
+  if (hal::bit_extract<dwt_control::sleep_count_enable>(m_enabled_counters)) {
+    result.sleep = m_sleep.update(counts.sleep & 0xFF);
+  }
+  if (hal::bit_extract<dwt_control::lsu_count_enable>(m_enabled_counters)) {
+    result.lsu = m_lsu.update(counts.lsu & 0xFF);
+  }
+  if (hal::bit_extract<dwt_control::fold_count_enable>(m_enabled_counters)) {
+    result.fold = m_fold.update(counts.fold & 0xFF);
+  }
+
+  return result;
+}
+
+void dwt_profiler::sample()
+{
+  static_cast<void>(snapshot());
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,305 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/exceptions.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <span>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal/error.hpp>
+
+#if defined(__arm__)
+#include <typeinfo>
+
+#include <unwind.h>
+#endif
+
+#if defined(__arm__)
+// Supplied by libhal-armcortex/standard.ld
+extern "C"
+{
+  extern hal::cortex_m::exception_index_entry const __exidx_start[];
+  extern hal::cortex_m::exception_index_entry const __exidx_end[];
+}
+#endif
+
+namespace hal::cortex_m {
+namespace {
+#if defined(__arm__)
+/// Mirrors __cxa_refcounted_exception of GCC's ARM EHABI runtime, declared in
+/// its private unwind-cxx.h header, which the runtime places in front of each
+/// exception object.
+struct refcounted_exception_layout
+{
+  int reference_count;
+  std::type_info* exception_type;
+  void (*exception_destructor)(void*);
+  std::terminate_handler unexpected_handler;
+  std::terminate_handler terminate_handler;
+  void* next_exception;
+  int handler_count;
+  void* next_propagating_exception;
+  int propagation_count;
+  _Unwind_Control_Block unwind_header;
+};
+
+static_assert(sizeof(refcounted_exception_layout) == exception_header_size,
+              "exception_header_size must match the size of the runtime's "
+              "__cxa_refcounted_exception");
+#endif
+
+std::array<exception_pool_block, default_exception_pool_size> default_blocks{};
+std::span<exception_pool_block> pool_blocks{};
+exception_pool_block* free_blocks = nullptr;
+std::size_t free_block_count = 0;
+
+#if defined(__arm__)
+std::span<exception_index_entry const> index_table{ __exidx_start,
+                                                    __exidx_end };
+#else
+std::span<exception_index_entry const> index_table{};
+#endif
+std::span<std::uint32_t> index_buckets{};
+std::uintptr_t index_start = 0;
+std::uintptr_t bytes_per_bucket = 1;
+
+void link_blocks(std::span<exception_pool_block> p_blocks)
+{
+  pool_blocks = p_blocks;
+  free_blocks = nullptr;
+  for (std::size_t i = p_blocks.size(); i > 0; i--) {
+    p_blocks[i - 1].next = free_blocks;
+    free_blocks = &p_blocks[i - 1];
+  }
+  free_block_count = p_blocks.size();
+}
+
+exception_pool_block* take_block()
+{
+  critical_section lock;
+
+  // Exceptions can be thrown by constructors of global objects, before main()
+  // has had the chance to initialize the pool.
+  if (pool_blocks.empty()) {
+    link_blocks(default_blocks);
+  }
+
+  auto* const block = free_blocks;
+  if (block == nullptr) {
+    return nullptr;
+  }
+  free_blocks = block->next;
+  free_block_count--;
+  return block;
+}
+
+/// Decode the function address of an entry from its prel31 offset
+std::uintptr_t function_address(exception_index_entry const& p_entry)
+{
+  // Shift the 31-bit offset up to bit 31 and back, extending its sign
+  auto const offset =
+    static_cast<std::int32_t>(p_entry.function_offset << 1) >> 1;
+  return reinterpret_cast<std::uintptr_t>(&p_entry.function_offset) +
+         static_cast<std::uintptr_t>(static_cast<std::intptr_t>(offset));
+}
+}  // namespace
+
+void initialize_exception_pool(std::span<exception_pool_block> p_blocks)
+{
+  if (p_blocks.empty()) {
+    hal::safe_throw(hal::argument_out_of_domain(nullptr));
+  }
+
+  critical_section lock;
+  link_blocks(p_blocks);
+}
+
+void* allocate_exception(std::size_t p_object_size)
+{
+  if (p_object_size > max_exception_object_size) {
+    return nullptr;
+  }
+
+  auto* const block = take_block();
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  std::memset(block->storage.data(), 0, exception_header_size);
+  return block->storage.data() + exception_header_size;
+}
+
+void* allocate_dependent_exception()
+{
+  auto* const block = take_block();
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  std::memset(block->storage.data(), 0, exception_header_size);
+  return block->storage.data();
+}
+
+void free_exception(void* p_exception)
+{
+  critical_section lock;
+
+  auto const address = reinterpret_cast<std::uintptr_t>(p_exception);
+  auto const start = reinterpret_cast<std::uintptr_t>(pool_blocks.data());
+  auto const end = start + pool_blocks.size_bytes();
+  if (address < start || address >= end) {
+    return;
+  }
+
+  auto& block = pool_blocks[(address - start) / sizeof(exception_pool_block)];
+  block.next = free_blocks;
+  free_blocks = &block;
+  free_block_count++;
+}
+
+std::size_t exception_pool_available()
+{
+  critical_section lock;
+
+  if (pool_blocks.empty()) {
+    return default_blocks.size();
+  }
+  return free_block_count;
+}
+
+void initialize_exception_index(std::span<exception_index_entry const> p_table,
+                                std::span<std::uint32_t> p_buckets)
+{
+  if (p_buckets.size() < 2) {
+    hal::safe_throw(hal::argument_out_of_domain(nullptr));
+  }
+
+  index_table = p_table;
+  index_buckets = {};
+  if (p_table.empty()) {
+    return;
+  }
+
+  index_start = function_address(p_table.front());
+  auto const length = function_address(p_table.back()) - index_start + 1;
+  bytes_per_bucket = (length + p_buckets.size() - 1) / p_buckets.size();
+
+  // Each bucket stores the last entry starting at or before the bucket, which
+  // is the entry covering the first address of the bucket.
+  std::uint32_t entry = 0;
+  for (std::size_t i = 0; i < p_buckets.size(); i++) {
+    auto const bucket_start = index_start + (i * bytes_per_bucket);
+    while (entry + 1 < p_table.size() &&
+           function_address(p_table[entry + 1]) <= bucket_start) {
+      entry++;
+    }
+    p_buckets[i] = entry;
+  }
+
+  index_buckets = p_buckets;
+}
+
+void initialize_exception_index(
+  [[maybe_unused]] std::span<std::uint32_t> p_buckets)
+{
+#if defined(__arm__)
+  initialize_exception_index({ __exidx_start, __exidx_end }, p_buckets);
+#endif
+}
+
+std::span<exception_index_entry const> find_exception_index(
+  std::uintptr_t p_address)
+{
+  if (index_buckets.empty()) {
+    return index_table;
+  }
+
+  // The search fails for an address before the first function, as it should
+  if (p_address < index_start) {
+    return index_table.first(1);
+  }
+
+  auto const bucket = std::min<std::uintptr_t>(
+    (p_address - index_start) / bytes_per_bucket, index_buckets.size() - 1);
+  std::size_t const first = index_buckets[bucket];
+  std::size_t const last = (bucket + 1 < index_buckets.size())
+                             ? index_buckets[bucket + 1]
+                             : index_table.size() - 1;
+  return index_table.subspan(first, last - first + 1);
+}
+}  // namespace hal::cortex_m
+
+#if defined(__arm__) && not defined(LIBHAL_ARMCORTEX_USE_LIBHAL_EXCEPTIONS)
+// Replace the allocation functions of the C++ runtime, otherwise the runtime
+// allocates exceptions with malloc and only falls back to its own emergency
+// pool once the heap is exhausted. Every allocation function is replaced, as
+// the runtime defines them all within the same object file.
+//
+// libhal-exceptions owns the allocator and the unwinder when it is used, so
+// these are left to it.
+extern "C"
+{
+  void* __cxa_allocate_exception(std::size_t p_thrown_size) noexcept
+  {
+    auto* const object = hal::cortex_m::allocate_exception(p_thrown_size);
+    if (object == nullptr) {
+      std::terminate();
+    }
+    return object;
+  }
+
+  void __cxa_free_exception(void* p_object) noexcept
+  {
+    hal::cortex_m::free_exception(p_object);
+  }
+
+  void* __cxa_allocate_dependent_exception() noexcept
+  {
+    auto* const dependent = hal::cortex_m::allocate_dependent_exception();
+    if (dependent == nullptr) {
+      std::terminate();
+    }
+    return dependent;
+  }
+
+  void __cxa_free_dependent_exception(void* p_dependent) noexcept
+  {
+    hal::cortex_m::free_exception(p_dependent);
+  }
+
+  /**
+   * @brief Find the exception index entries that may cover an address
+   *
+   * Weakly referenced by the unwinder of libgcc, which otherwise searches the
+   * whole table.
+   *
+   * @param p_address - address within the function being unwound
+   * @param p_count - set to the number of entries returned
+   * @return std::uintptr_t - address of the first entry returned
+   */
+  std::uintptr_t __gnu_Unwind_Find_exidx(std::uintptr_t p_address,
+                                         int* p_count)
+  {
+    auto const entries = hal::cortex_m::find_exception_index(p_address);
+    *p_count = static_cast<int>(entries.size());
+    return reinterpret_cast<std::uintptr_t>(entries.data());
+  }
+}
+#endif
@@ -0,0 +1,249 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <libhal-armcortex/fault.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-armcortex/system_control.hpp>
+#include <libhal-util/bit.hpp>
+#include <libhal/units.hpp>
+
+#include "system_controller_reg.hpp"
+
+#if defined(__arm__)
+// Supplied by libhal-armcortex/standard.ld
+extern "C"
+{
+  extern std::uint32_t __stack;
+  extern std::uint32_t __text_start;
+  extern std::uint32_t __text_end;
+}
+#endif
+
+namespace hal::cortex_m {
+namespace {
+/// Words of the basic and extended exception frames
+constexpr std::size_t basic_frame_words = 8;
+constexpr std::size_t extended_frame_words = 26;
+/// Set in the stacked xPSR when a word of padding was added to align the
+/// frame to 8 bytes
+constexpr std::uint32_t xpsr_frame_padding = 1 << 9;
+/// Number of stack words above the frame searched for return addresses
+constexpr std::size_t backtrace_scan_words = 64;
+
+/// Marks the preserved record as written by the fault handler
+constexpr std::uint32_t fault_record_magic = 0xFA17'C0DE;
+
+struct preserved_fault_record
+{
+  std::uint32_t magic;
+  fault_record record;
+  std::uint32_t checksum;
+};
+
+#if defined(__arm__)
+[[gnu::section(".preserve.fault_record")]]
+#endif
+preserved_fault_record preserved;
+
+std::uint32_t checksum_of(fault_record const& p_record)
+{
+  static_assert(sizeof(fault_record) % sizeof(std::uint32_t) == 0);
+  auto const words = std::bit_cast<
+    std::array<std::uint32_t, sizeof(fault_record) / sizeof(std::uint32_t)>>(
+    p_record);
+
+  std::uint32_t sum = fault_record_magic;
+  for (auto const word : words) {
+    sum = std::rotl(sum, 1) + word;
+  }
+  return ~sum;
+}
+
+bool stacking_faulted(std::uint32_t p_cfsr)
+{
+  namespace cfsr = configurable_fault_status;
+  return hal::bit_extract<cfsr::memory_stacking_error>(p_cfsr) ||
+         hal::bit_extract<cfsr::bus_stacking_error>(p_cfsr) ||
+         hal::bit_extract<cfsr::stack_overflow>(p_cfsr);
+}
+
+bool is_code_address(std::uint32_t p_address)
+{
+  // Return addresses of thumb code always have bit 0 set
+  if ((p_address & 1U) == 0U) {
+    return false;
+  }
+#if defined(__arm__)
+  auto const start = reinterpret_cast<std::uintptr_t>(&__text_start);
+  auto const end = reinterpret_cast<std::uintptr_t>(&__text_end);
+  return start <= p_address && p_address < end;
+#else
+  return true;
+#endif
+}
+
+/// Stack words between the top of the exception frame and the end of the
+/// scan, which never passes the top of RAM.
+std::span<std::uint32_t const> stack_above(std::uint32_t const* p_frame,
+                                           std::size_t p_frame_words)
+{
+  auto const* const start = p_frame + p_frame_words;
+  auto const* end = start + backtrace_scan_words;
+#if defined(__arm__)
+  auto const* const top = &__stack;
+  if (start >= top) {
+    return {};
+  }
+  if (end > top) {
+    end = top;
+  }
+#endif
+  return { start, end };
+}
+
+void capture_backtrace(fault_record& p_record, std::uint32_t const* p_frame)
+{
+  auto push = [&p_record](std::uint32_t p_address) {
+    if (p_record.backtrace_depth < p_record.backtrace.size()) {
+      p_record.backtrace[p_record.backtrace_depth++] = p_address;
+    }
+  };
+
+  push(p_record.frame.pc);
+  push(p_record.frame.lr);
+
+  auto frame_words = is_extended_exception_frame(p_record.exc_return)
+                       ? extended_frame_words
+                       : basic_frame_words;
+  if ((p_record.frame.xpsr & xpsr_frame_padding) != 0U) {
+    frame_words++;
+  }
+
+  for (auto const word : stack_above(p_frame, frame_words)) {
+    if (is_code_address(word)) {
+      push(word);
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Record a fault into the preserved fault record
+ *
+ * @param p_frame - exception frame pushed on entry to the fault
+ * @param p_exc_return - link register on entry to the fault handler
+ */
+extern "C" void hal_cortex_m_record_fault(std::uint32_t const* p_frame,
+                                          std::uint32_t p_exc_return)
+{
+  auto& record = preserved.record;
+  record = {};
+  record.exc_return = p_exc_return;
+  record.exception_number =
+    hal::bit_extract<interrupt_control_state::vector_active>(scb->icsr);
+  record.cfsr = scb->cfsr;
+  record.hfsr = scb->hfsr;
+  record.mmfar = scb->mmfar;
+  record.bfar = scb->bfar;
+
+  bool const aligned =
+    (reinterpret_cast<std::uintptr_t>(p_frame) % sizeof(std::uint32_t)) == 0;
+  if (p_frame != nullptr && aligned && not stacking_faulted(record.cfsr)) {
+    record.frame = { .r0 = p_frame[0],
+                     .r1 = p_frame[1],
+                     .r2 = p_frame[2],
+                     .r3 = p_frame[3],
+                     .r12 = p_frame[4],
+                     .lr = p_frame[5],
+                     .pc = p_frame[6],
+                     .xpsr = p_frame[7] };
+    capture_backtrace(record, p_frame);
+  }
+
+  preserved.checksum = checksum_of(record);
+  preserved.magic = fault_record_magic;
+}
+
+/**
+ * @brief Record a fault then reset the system
+ *
+ * @param p_frame - exception frame pushed on entry to the fault
+ * @param p_exc_return - link register on entry to the fault handler
+ */
+extern "C" void hal_cortex_m_capture_fault(std::uint32_t const* p_frame,
+                                           std::uint32_t p_exc_return)
+{
+  hal_cortex_m_record_fault(p_frame, p_exc_return);
+
+  // The record must reach RAM before the reset discards the data cache
+  if (hal::bit_extract<configuration_control::data_cache_enable>(scb->ccr)) {
+    clean_dcache({ reinterpret_cast<hal::byte const*>(&preserved),
+                   sizeof(preserved) });
+  }
+  data_synchronization_barrier();
+  reset();
+}
+
+#if defined(__arm__)
+// Bit 2 of EXC_RETURN selects the stack the frame was pushed onto. Only
+// instructions available on every Cortex M are used.
+[[gnu::naked]] void fault_capture_handler()
+{
+  asm volatile("movs r0, #4\n"
+               "mov r1, lr\n"
+               "tst r0, r1\n"
+               "beq 1f\n"
+               "mrs r0, psp\n"
+               "bl hal_cortex_m_capture_fault\n"
+               "1:\n"
+               "mrs r0, msp\n"
+               "bl hal_cortex_m_capture_fault\n");
+}
+#else
+void fault_capture_handler()
+{
+}
+#endif
+
+void install_fault_capture()
+{
+  enable_interrupt(irq::hard_fault, fault_capture_handler);
+  enable_interrupt(irq::memory_management_fault, fault_capture_handler);
+  enable_interrupt(irq::bus_fault, fault_capture_handler);
+  enable_interrupt(irq::usage_fault, fault_capture_handler);
+}
+
+bool take_fault_record(fault_record& p_record)
+{
+  bool const valid = preserved.magic == fault_record_magic &&
+                     preserved.checksum == checksum_of(preserved.record);
+  preserved.magic = 0;
+
+  if (not valid) {
+    return false;
+  }
+
+  p_record = preserved.record;
+  return true;
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,147 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/idle.hpp>
+
+#include <cstdint>
+
+#include <libhal-armcortex/system_control.hpp>
+#include <libhal-util/bit.hpp>
+#include <libhal/units.hpp>
+
+#include "dwt_counter_reg.hpp"
+#include "system_controller_reg.hpp"
+
+namespace hal::cortex_m {
+namespace {
+hal::time_duration deep_sleep_threshold = hal::time_duration::max();
+idle_statistics statistics{};
+std::uint32_t last_wake_up = 0;
+
+/**
+ * @brief Sleep with WFI and timestamp the wake up before any handler runs
+ *
+ * WFI wakes on a pending interrupt even with PRIMASK set, so the cycle count
+ * is read before the waking interrupt's handler is allowed to run.
+ *
+ * @return std::uint32_t - cycle count at wake up
+ */
+std::uint32_t sleep_until_interrupt()
+{
+  std::uint32_t primask = 0;
+#if defined(__arm__)
+  asm volatile("mrs %0, primask" : "=r"(primask) : : "memory");
+  asm volatile("cpsid i" : : : "memory");
+#endif
+
+  wait_for_interrupt();
+  auto const wake_up = dwt->cyccnt;
+
+#if defined(__arm__)
+  asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+#endif
+  static_cast<void>(primask);
+
+  return wake_up;
+}
+
+/**
+ * @brief Sleep with WFE
+ *
+ * WFE is not woken by interrupts masked with PRIMASK unless
+ * send_event_on_pending is set, so it cannot be masked like WFI. The cycle
+ * count is read after the handler of a waking interrupt has run.
+ *
+ * @return std::uint32_t - cycle count at wake up
+ */
+std::uint32_t sleep_until_event()
+{
+  wait_for_event();
+  return dwt->cyccnt;
+}
+
+sleep_depth enter_sleep(hal::time_duration p_until_deadline,
+                        std::uint32_t (*p_wait)())
+{
+  auto const depth = select_sleep_depth(p_until_deadline);
+
+  scb->scr =
+    hal::bit_value<std::uint32_t>(scb->scr)
+      .insert<system_control::sleep_deep>(static_cast<std::uint32_t>(depth))
+      .get();
+
+  auto const sleep_start = dwt->cyccnt;
+  auto const wake_up = p_wait();
+
+  // Unsigned subtraction handles a single wrap of the counter
+  statistics.awake_cycles += sleep_start - last_wake_up;
+  statistics.asleep_cycles += wake_up - sleep_start;
+  last_wake_up = wake_up;
+
+  if (depth == sleep_depth::deep_sleep) {
+    statistics.deep_sleeps++;
+  } else {
+    statistics.sleeps++;
+  }
+
+  return depth;
+}
+}  // namespace
+
+void configure_idle(idle_settings const& p_settings)
+{
+  deep_sleep_threshold = p_settings.deep_sleep_threshold;
+
+  scb->scr = hal::bit_value<std::uint32_t>(scb->scr)
+               .insert<system_control::sleep_on_exit>(
+                 static_cast<std::uint32_t>(p_settings.sleep_on_exit))
+               .insert<system_control::send_event_on_pending>(
+                 static_cast<std::uint32_t>(p_settings.send_event_on_pending))
+               .get();
+
+  core->demcr = (core->demcr | core_trace_enable);
+  dwt->ctrl = (dwt->ctrl | enable_cycle_count);
+
+  reset_idle_statistics();
+}
+
+sleep_depth select_sleep_depth(hal::time_duration p_until_deadline)
+{
+  if (p_until_deadline > deep_sleep_threshold) {
+    return sleep_depth::deep_sleep;
+  }
+  return sleep_depth::sleep;
+}
+
+sleep_depth idle(hal::time_duration p_until_deadline)
+{
+  return enter_sleep(p_until_deadline, sleep_until_interrupt);
+}
+
+sleep_depth idle_until_event(hal::time_duration p_until_deadline)
+{
+  return enter_sleep(p_until_deadline, sleep_until_event);
+}
+
+idle_statistics get_idle_statistics()
+{
+  return statistics;
+}
+
+void reset_idle_statistics()
+{
+  statistics = {};
+  last_wake_up = dwt->cyccnt;
+}
+}  // namespace hal::cortex_m
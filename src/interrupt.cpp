@@ -15,18 +15,67 @@
 #include <libhal-armcortex/interrupt.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <span>
+#include <utility>
 
 #include <libhal-armcortex/system_control.hpp>
 #include <libhal-util/enum.hpp>
 
+#include "dwt_counter_reg.hpp"
 #include "interrupt_reg.hpp"
+#include "system_controller_reg.hpp"
 
 namespace hal::cortex_m {
 namespace {
-/// Pointer to a statically allocated interrupt vector table
-std::span<interrupt_pointer> vector_table{};
+/// Interrupt bookkeeping of a single core
+struct core_interrupt_state
+{
+  /// Pointer to a statically allocated interrupt vector table
+  std::span<interrupt_pointer> vector_table{};
+
+  /// Set to true when vector_table refers to a flash resident static vector
+  /// table, which cannot be written to.
+  bool vector_table_is_read_only = false;
+
+  /// Handlers of each vector, indexed by exception number, while the
+  /// instrumented dispatcher is in use. Empty otherwise.
+  std::span<interrupt_pointer> instrumented_handlers{};
+
+  /// Statistics of each vector, indexed by exception number
+  std::span<irq_statistics> interrupt_statistics{};
+
+  /// Number of instrumented handlers currently running
+  std::uint8_t nesting_depth = 0;
+
+  /// Running total of cycles spent in instrumented handlers, used to remove
+  /// the time spent in nested handlers from the handlers they preempted.
+  std::uint32_t instrumented_cycles = 0;
+
+  /// Callbacks of each vector, callbacks_per_irq entries per exception number.
+  /// Empty until the dispatch table is initialized.
+  std::span<irq_callback> irq_callbacks{};
+
+  /// Number of callbacks that can share each vector
+  std::size_t callbacks_per_irq = 0;
+};
+
+std::uint32_t single_core_id()
+{
+  return 0;
+}
+
+/// Reads the number of the executing core
+core_id_function core_id_source = single_core_id;
+
+/// Each core has its own NVIC and VTOR, and thus its own bookkeeping
+std::array<core_interrupt_state, max_cores> core_states{};
+
+core_interrupt_state& local_state()
+{
+  return core_states[current_core()];
+}
 
 std::int32_t register_index(irq_t p_irq)
 {
@@ -81,22 +130,38 @@ void setup_default_vector_table(std::span<interrupt_pointer> p_vector_table)
     p_vector_table.begin(), p_vector_table.end(), &default_interrupt_handler);
 }
 
-constexpr bool is_the_same_vector_buffer(
+bool is_the_same_vector_buffer(
   std::span<interrupt_pointer> p_vector_table)
 {
+  auto& state = local_state();
   p_vector_table = p_vector_table.subspan(core_interrupts);
-  return (p_vector_table.data() == vector_table.data() &&
-          p_vector_table.size() == vector_table.size());
+  return (p_vector_table.data() == state.vector_table.data() &&
+          p_vector_table.size() == state.vector_table.size());
+}
+
+/**
+ * @brief Determine if this core's vector table has been initialized
+ *
+ * Unlike `interrupt_vector_table_initialized()`, this does not read VTOR, which
+ * keeps it cheap enough for the paths that enable, disable and prioritize
+ * interrupts.
+ *
+ * @return true - if the vector table has been initialized
+ */
+bool vector_table_in_use()
+{
+  return not local_state().vector_table.empty();
 }
 
 bool is_valid_irq_request(irq_t p_irq)
 {
-  if (not interrupt_vector_table_initialized()) {
+  if (not vector_table_in_use()) {
     return false;
   }
 
+  auto const vector_count = local_state().vector_table.size();
   bool within_bounds = hal::value(irq::top_of_stack) <= p_irq &&
-                       p_irq <= static_cast<irq_t>(vector_table.size());
+                       p_irq <= static_cast<irq_t>(vector_count);
 
   if (not within_bounds) {
     return false;
@@ -104,6 +169,286 @@ bool is_valid_irq_request(irq_t p_irq)
 
   return true;
 }
+
+std::size_t exception_number_of(irq_t p_irq)
+{
+  return static_cast<std::size_t>(p_irq - core_interrupts);
+}
+
+/**
+ * @brief Determine if a handler depends on the state on exception entry
+ *
+ * The fault handlers read EXC_RETURN from the link register and SVCall &
+ * PendSV handlers, such as the context switch handler, manipulate the stack
+ * frame of the code they preempt. Both break when called from the trampoline.
+ * NMI cannot be masked by PRIMASK, which the trampoline relies on to update
+ * the statistics, thus an instrumented NMI could corrupt the statistics of
+ * the interrupt it preempts.
+ *
+ * @param p_irq - irq to check
+ * @return true - if the handler of the irq must run directly from the vector
+ */
+bool requires_exception_entry(irq_t p_irq)
+{
+  switch (static_cast<irq>(p_irq)) {
+    case irq::non_maskable_interrupt:
+    case irq::hard_fault:
+    case irq::memory_management_fault:
+    case irq::bus_fault:
+    case irq::usage_fault:
+    case irq::software_call:
+    case irq::pend_sv:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool is_instrumented(irq_t p_irq)
+{
+  // The top of stack and reset vectors are not handlers and must never be
+  // replaced with the trampoline.
+  auto const handler_count = local_state().instrumented_handlers.size();
+  return p_irq >= hal::value(irq::non_maskable_interrupt) &&
+         exception_number_of(p_irq) < handler_count &&
+         not requires_exception_entry(p_irq);
+}
+
+/// Get the handler that runs when the irq fires
+interrupt_pointer installed_handler(irq_t p_irq)
+{
+  if (is_instrumented(p_irq)) {
+    return local_state().instrumented_handlers[exception_number_of(p_irq)];
+  }
+  return local_state().vector_table[p_irq];
+}
+
+/**
+ * @brief Get the callbacks of an irq
+ *
+ * @param p_irq - irq to get the callbacks of
+ * @return std::span<irq_callback> - callbacks of the irq, empty if the irq
+ * cannot have callbacks or the dispatch table has not been initialized.
+ */
+std::span<irq_callback> callbacks_of(irq_t p_irq)
+{
+  auto& state = local_state();
+  bool const within_bounds =
+    hal::value(irq::non_maskable_interrupt) <= p_irq &&
+    p_irq < static_cast<irq_t>(state.vector_table.size());
+
+  if (state.irq_callbacks.empty() || not within_bounds) {
+    return {};
+  }
+
+  return state.irq_callbacks.subspan(
+    exception_number_of(p_irq) * state.callbacks_per_irq,
+    state.callbacks_per_irq);
+}
+
+std::uint32_t mask_all_interrupts()
+{
+  std::uint32_t primask = 0;
+#if defined(__arm__)
+  asm volatile("mrs %0, primask" : "=r"(primask) : : "memory");
+  asm volatile("cpsid i" : : : "memory");
+#endif
+  return primask;
+}
+
+void restore_interrupt_mask([[maybe_unused]] std::uint32_t p_primask)
+{
+#if defined(__arm__)
+  asm volatile("msr primask, %0" : : "r"(p_primask) : "memory");
+#endif
+}
+
+std::uint32_t active_exception_number()
+{
+  constexpr std::uint32_t exception_number_mask = 0x1FF;
+#if defined(__arm__)
+  std::uint32_t ipsr = 0;
+  asm volatile("mrs %0, ipsr" : "=r"(ipsr));
+  return ipsr & exception_number_mask;
+#else
+  // ICSR.VECTACTIVE mirrors IPSR and is memory mapped, which allows unit tests
+  // to select the active exception.
+  return scb->icsr & exception_number_mask;
+#endif
+}
+
+/// Trampoline installed into every vector while in the instrumented mode
+void instrumented_interrupt_handler()
+{
+  auto& state = local_state();
+  auto const exception_number = active_exception_number();
+  auto& statistics = state.interrupt_statistics[exception_number];
+
+  auto mask = mask_all_interrupts();
+  state.nesting_depth++;
+  statistics.max_nesting =
+    std::max(statistics.max_nesting, state.nesting_depth);
+  auto const cycles_on_entry = state.instrumented_cycles;
+  auto const start = dwt->cyccnt;
+  restore_interrupt_mask(mask);
+
+  state.instrumented_handlers[exception_number]();
+
+  mask = mask_all_interrupts();
+  auto const cycles = dwt->cyccnt - start;
+  auto const nested_cycles = state.instrumented_cycles - cycles_on_entry;
+  auto const own_cycles = cycles - nested_cycles;
+  state.instrumented_cycles = cycles_on_entry + cycles;
+  state.nesting_depth--;
+  statistics.entries++;
+  statistics.total_cycles += own_cycles;
+  statistics.max_cycles = std::max(statistics.max_cycles, own_cycles);
+  restore_interrupt_mask(mask);
+}
+
+/// The first core interrupt with a programmable priority
+constexpr auto first_configurable_core_irq =
+  hal::value(irq::memory_management_fault);
+
+mmio<std::uint8_t>* priority_field(irq_t p_irq)
+{
+  if (not is_valid_irq_request(p_irq)) {
+    return nullptr;
+  }
+
+  if (p_irq >= 0) {
+    if (static_cast<std::size_t>(p_irq) >= nvic->ip.size()) {
+      return nullptr;
+    }
+    return &nvic->ip[p_irq];
+  }
+
+  if (p_irq < first_configurable_core_irq) {
+    // Reset, NMI & HardFault have fixed priorities
+    return nullptr;
+  }
+
+  return &scb->shp[p_irq - first_configurable_core_irq];
+}
+
+void write_priority_field(mmio<std::uint8_t>* p_field,
+                          std::uint8_t p_priority)
+{
+#if defined(__ARM_ARCH_6M__)
+  // ARMv6-M only supports word accesses to the NVIC and system handler
+  // priority registers, so the field must be updated via read-modify-write of
+  // the word that contains it.
+  auto const address = reinterpret_cast<std::uintptr_t>(p_field);
+  auto* word = reinterpret_cast<std::uint32_t volatile*>(address & ~0b11U);
+  auto const shift = (address & 0b11U) * 8U;
+  *word = (*word & ~(0xFFU << shift)) | (std::uint32_t{ p_priority } << shift);
+#else
+  *p_field = p_priority;
+#endif
+}
+
+std::uint8_t read_priority_field(mmio<std::uint8_t>* p_field)
+{
+#if defined(__ARM_ARCH_6M__)
+  auto const address = reinterpret_cast<std::uintptr_t>(p_field);
+  auto* word = reinterpret_cast<std::uint32_t volatile*>(address & ~0b11U);
+  auto const shift = (address & 0b11U) * 8U;
+  return static_cast<std::uint8_t>(*word >> shift);
+#else
+  return *p_field;
+#endif
+}
+/**
+ * @brief Place the handler into the vector table
+ *
+ * @param p_irq - a valid irq
+ * @param p_handler - handler for the irq
+ * @return true - if the irq may be enabled with this handler
+ */
+bool install_handler(irq_t p_irq, interrupt_pointer p_handler)
+{
+  auto& state = local_state();
+  if (state.vector_table_is_read_only) {
+    // Handlers of a flash resident vector table are bound at compile time, so
+    // only enable the IRQ if the handler is the one that was bound.
+    return state.vector_table[p_irq] == p_handler;
+  }
+
+  if (is_instrumented(p_irq)) {
+    state.instrumented_handlers[exception_number_of(p_irq)] = p_handler;
+    state.vector_table[p_irq] = instrumented_interrupt_handler;
+  } else {
+    state.vector_table[p_irq] = p_handler;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Get the mask of IRQs within an NVIC register that are within the
+ * range of the interrupt vector table
+ *
+ * @param p_index - index of the NVIC register
+ * @return std::uint32_t - mask of the IRQs in range
+ */
+std::uint32_t irqs_in_range(std::size_t p_index)
+{
+  constexpr std::size_t register_width = 32;
+  auto const first = p_index * register_width;
+  auto const count = local_state().vector_table.size();
+
+  if (count <= first) {
+    return 0;
+  }
+  if (count - first >= register_width) {
+    return 0xFFFF'FFFF;
+  }
+  return (1U << (count - first)) - 1U;
+}
+
+/**
+ * @brief Write the masks of the irq set to a bank of NVIC registers
+ *
+ * Registers without any IRQs of the set are not written. Interrupts are
+ * masked throughout, such that the writes take effect at the same instant.
+ *
+ * @param p_registers - the set, clear, pend or clear pending registers
+ * @param p_irqs - the irqs to write
+ */
+void write_irq_masks(std::array<mmio<std::uint32_t>, 8>& p_registers,
+                     irq_set const& p_irqs)
+{
+  if (not vector_table_in_use()) {
+    return;
+  }
+
+  critical_section lock;
+  for (std::size_t i = 0; i < p_registers.size(); i++) {
+    auto const mask = p_irqs.mask(i) & irqs_in_range(i);
+    if (mask != 0U) {
+      p_registers[i] = mask;
+    }
+  }
+}
+/**
+ * @brief Determine if the irq has a bit within the NVIC registers
+ *
+ * Only checks the range of the vector table, which is empty until it has been
+ * initialized, keeping the check cheap enough for use within interrupts.
+ *
+ * @param p_irq - irq to check
+ * @return true - if the irq is within the NVIC and the vector table
+ */
+bool is_nvic_irq(irq_t p_irq)
+{
+  return 0 <= p_irq &&
+         static_cast<std::size_t>(p_irq) < local_state().vector_table.size();
+}
+
+std::uint32_t nvic_bit(irq_t p_irq)
+{
+  return 1U << (p_irq % 32);
+}
 }  // namespace
 
 void default_interrupt_handler()
@@ -155,15 +500,57 @@ void enable_all_interrupts()
 #endif
 }
 
+critical_section::critical_section([[maybe_unused]] std::uint8_t p_threshold)
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__)
+  if (p_threshold != 0U) {
+    asm volatile("mrs %0, basepri" : "=r"(m_previous_mask) : : "memory");
+    // BASEPRI_MAX only updates BASEPRI if the new value raises the masking
+    // level, which keeps nested critical sections from unmasking interrupts.
+    asm volatile("msr basepri_max, %0" : : "r"(p_threshold) : "memory");
+    std::uint32_t basepri = 0;
+    asm volatile("mrs %0, basepri" : "=r"(basepri) : : "memory");
+    if (basepri != 0U) {
+      return;
+    }
+  }
+#endif
+  // ARMv6-M has no BASEPRI. Elsewhere, a BASEPRI of zero, from a threshold of
+  // zero or one whose implemented priority bits are all zero, masks nothing,
+  // so every configurable interrupt is masked instead.
+  m_previous_mask = mask_all_interrupts();
+  m_masks_all = true;
+}
+
+critical_section::critical_section()
+  : m_previous_mask(mask_all_interrupts())
+  , m_masks_all(true)
+{
+}
+
+critical_section::~critical_section()
+{
+  if (m_masks_all) {
+    restore_interrupt_mask(m_previous_mask);
+    return;
+  }
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__)
+  asm volatile("msr basepri, %0" : : "r"(m_previous_mask) : "memory");
+#endif
+}
+
 bool interrupt_vector_table_initialized()
 {
   return get_interrupt_vector_table_address() ==
-         (vector_table.data() + core_interrupts);
+         (local_state().vector_table.data() + core_interrupts);
 }
 
 std::span<interrupt_pointer> const get_vector_table()
 {
-  return vector_table;
+  return local_state().vector_table;
 }
 
 void enable_interrupt(irq_t p_irq, interrupt_pointer p_handler)
@@ -172,7 +559,9 @@ void enable_interrupt(irq_t p_irq, interrupt_pointer p_handler)
     return;
   }
 
-  vector_table[p_irq] = p_handler;
+  if (not install_handler(p_irq, p_handler)) {
+    return;
+  }
 
   if (p_irq >= 0) {
     nvic_enable_irq(p_irq);
@@ -192,6 +581,230 @@ void disable_interrupt(irq_t p_irq)
   nvic_disable_irq(p_irq);
 }
 
+void enable_interrupts(irq_set const& p_irqs)
+{
+  write_irq_masks(nvic->iser, p_irqs);
+}
+
+void disable_interrupts(irq_set const& p_irqs)
+{
+  write_irq_masks(nvic->icer, p_irqs);
+}
+
+void pend_interrupts(irq_set const& p_irqs)
+{
+  write_irq_masks(nvic->ispr, p_irqs);
+}
+
+void clear_pending_interrupts(irq_set const& p_irqs)
+{
+  write_irq_masks(nvic->icpr, p_irqs);
+}
+
+void enable_interrupts(std::span<interrupt_binding const> p_bindings)
+{
+  if (not vector_table_in_use()) {
+    return;
+  }
+
+  std::array<std::uint32_t, irq_set::register_count> masks{};
+  for (auto const& binding : p_bindings) {
+    bool const within_bounds =
+      hal::value(irq::non_maskable_interrupt) <= binding.irq &&
+      binding.irq < static_cast<irq_t>(local_state().vector_table.size());
+
+    if (not within_bounds) {
+      continue;
+    }
+
+    if (not install_handler(binding.irq, binding.handler)) {
+      continue;
+    }
+
+    if (binding.irq >= 0) {
+      masks[register_index(binding.irq)] |= 1U << (binding.irq % 32);
+    }
+  }
+
+  critical_section lock;
+  for (std::size_t i = 0; i < masks.size(); i++) {
+    if (masks[i] != 0U) {
+      nvic->iser[i] = masks[i];
+    }
+  }
+}
+
+void dispatch_irq_callbacks()
+{
+  auto& state = local_state();
+  auto const first = active_exception_number() * state.callbacks_per_irq;
+  auto const last = first + state.callbacks_per_irq;
+
+  // Callbacks are attached front to back, so the first empty callback ends
+  // the chain.
+  for (auto i = first; i < last; i++) {
+    auto& callback = state.irq_callbacks[i];
+    if (not callback) {
+      return;
+    }
+    callback();
+  }
+}
+
+void initialize_irq_dispatch(std::span<irq_callback> p_callbacks,
+                             std::size_t p_callbacks_per_irq)
+{
+  auto& state = local_state();
+
+  if (not interrupt_vector_table_initialized() ||
+      not state.irq_callbacks.empty() || p_callbacks_per_irq == 0) {
+    return;
+  }
+
+  auto const vector_count = state.vector_table.size() - core_interrupts;
+  auto const callback_count = vector_count * p_callbacks_per_irq;
+  if (p_callbacks.size() < callback_count) {
+    return;
+  }
+
+  critical_section lock;
+  state.irq_callbacks = p_callbacks.first(callback_count);
+  state.callbacks_per_irq = p_callbacks_per_irq;
+  std::fill(state.irq_callbacks.begin(), state.irq_callbacks.end(), nullptr);
+}
+
+void attach_interrupt(irq_t p_irq, irq_callback p_callback)
+{
+  if (local_state().irq_callbacks.empty()) {
+    hal::safe_throw(hal::operation_not_permitted(nullptr));
+  }
+
+  auto const callbacks = callbacks_of(p_irq);
+  if (callbacks.empty() || not p_callback) {
+    return;
+  }
+
+  {
+    critical_section lock;
+    auto const unused = std::find_if(
+      callbacks.begin(), callbacks.end(), [](auto& p_entry) {
+        return not p_entry;
+      });
+
+    if (unused == callbacks.end()) {
+      hal::safe_throw(hal::resource_unavailable_try_again(nullptr));
+    }
+
+    *unused = std::move(p_callback);
+  }
+
+  enable_interrupt(p_irq, dispatch_irq_callbacks);
+}
+
+void detach_interrupts(irq_t p_irq)
+{
+  auto const callbacks = callbacks_of(p_irq);
+  if (callbacks.empty()) {
+    return;
+  }
+
+  disable_interrupt(p_irq);
+
+  critical_section lock;
+  std::fill(callbacks.begin(), callbacks.end(), nullptr);
+}
+
+void trigger_interrupt(irq_t p_irq)
+{
+  namespace icsr = interrupt_control_state;
+
+  if (p_irq == hal::value(irq::pend_sv)) {
+    scb->icsr = icsr::pend_sv_set.value<std::uint32_t>();
+    return;
+  }
+
+  if (p_irq == hal::value(irq::systick)) {
+    scb->icsr = icsr::pend_systick_set.value<std::uint32_t>();
+    return;
+  }
+
+  if (not is_nvic_irq(p_irq)) {
+    return;
+  }
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||                  \
+  defined(__ARM_ARCH_8M_MAIN__)
+  nvic->stir = static_cast<std::uint32_t>(p_irq);
+#else
+  nvic->ispr[register_index(p_irq)] = nvic_bit(p_irq);
+#endif
+}
+
+bool is_pending(irq_t p_irq)
+{
+  namespace icsr = interrupt_control_state;
+
+  if (p_irq == hal::value(irq::pend_sv)) {
+    return hal::bit_extract<icsr::pend_sv_set>(scb->icsr) != 0U;
+  }
+
+  if (p_irq == hal::value(irq::systick)) {
+    return hal::bit_extract<icsr::pend_systick_set>(scb->icsr) != 0U;
+  }
+
+  if (not is_nvic_irq(p_irq)) {
+    return false;
+  }
+
+  return (nvic->ispr[register_index(p_irq)] & nvic_bit(p_irq)) != 0U;
+}
+
+void clear_pending(irq_t p_irq)
+{
+  namespace icsr = interrupt_control_state;
+
+  if (p_irq == hal::value(irq::pend_sv)) {
+    scb->icsr = icsr::pend_sv_clear.value<std::uint32_t>();
+    return;
+  }
+
+  if (p_irq == hal::value(irq::systick)) {
+    scb->icsr = icsr::pend_systick_clear.value<std::uint32_t>();
+    return;
+  }
+
+  if (not is_nvic_irq(p_irq)) {
+    return;
+  }
+
+  nvic->icpr[register_index(p_irq)] = nvic_bit(p_irq);
+}
+
+bool is_active([[maybe_unused]] irq_t p_irq)
+{
+#if defined(__ARM_ARCH_6M__)
+  // ARMv6-M has neither the NVIC's active bit registers nor the active bits of
+  // the system handler control and state register.
+  return false;
+#else
+  namespace shcsr = system_handler_control_state;
+
+  if (p_irq == hal::value(irq::pend_sv)) {
+    return hal::bit_extract<shcsr::pend_sv_active>(scb->shcsr) != 0U;
+  }
+
+  if (p_irq == hal::value(irq::systick)) {
+    return hal::bit_extract<shcsr::systick_active>(scb->shcsr) != 0U;
+  }
+
+  if (not is_nvic_irq(p_irq)) {
+    return false;
+  }
+
+  return (nvic->iabr[register_index(p_irq)] & nvic_bit(p_irq)) != 0U;
+#endif
+}
+
 bool verify_vector_enabled(irq_t p_irq, interrupt_pointer p_handler)
 {
   if (!is_valid_irq_request(p_irq)) {
@@ -199,7 +812,7 @@ bool verify_vector_enabled(irq_t p_irq, interrupt_pointer p_handler)
   }
 
   // Check if the handler match
-  auto irq_handler = vector_table[p_irq];
+  auto irq_handler = installed_handler(p_irq);
   bool handlers_are_the_same = (irq_handler == p_handler);
 
   if (not handlers_are_the_same) {
@@ -215,8 +828,24 @@ bool verify_vector_enabled(irq_t p_irq, interrupt_pointer p_handler)
   return (enable_register & (1 << p_irq)) != 0U;
 }
 
+void set_core_id_source(core_id_function p_core_id)
+{
+  core_id_source = (p_core_id != nullptr) ? p_core_id : single_core_id;
+}
+
+std::uint32_t current_core()
+{
+  auto const core_index = core_id_source();
+  if (core_index >= max_cores) {
+    return 0;
+  }
+  return core_index;
+}
+
 void revert_interrupt_vector_table()
 {
+  auto& state = local_state();
+
   disable_all_interrupts();
 
   // Set all bits in the interrupt clear register to 1s to disable those
@@ -226,26 +855,46 @@ void revert_interrupt_vector_table()
   }
 
   // Reset vector table
-  vector_table = std::span<interrupt_pointer>();
+  state.vector_table = std::span<interrupt_pointer>();
+  state.vector_table_is_read_only = false;
+  state.instrumented_handlers = std::span<interrupt_pointer>();
+  state.interrupt_statistics = std::span<irq_statistics>();
+  state.nesting_depth = 0;
+  state.irq_callbacks = std::span<irq_callback>();
+  state.callbacks_per_irq = 0;
 }
 
 void initialize_interrupts(std::span<interrupt_pointer> p_vector_table)
 {
+  auto& state = local_state();
+
   // If initialize function has already been called before with this same
   // buffer, return early.
   if (is_the_same_vector_buffer(p_vector_table)) {
     return;
   }
 
+  // A flash resident vector table was chosen by the application and must not
+  // be replaced by drivers ensuring that interrupts have been initialized.
+  if (state.vector_table_is_read_only) {
+    return;
+  }
+
   setup_default_vector_table(p_vector_table);
 
   disable_all_interrupts();
 
-  // Assign the vector within this scope to the global vector_table span so
+  // The new table holds default handlers rather than trampolines
+  state.instrumented_handlers = std::span<interrupt_pointer>();
+  state.interrupt_statistics = std::span<irq_statistics>();
+  state.irq_callbacks = std::span<irq_callback>();
+  state.callbacks_per_irq = 0;
+
+  // Assign the vector within this scope to the core's vector_table span so
   // that it can be accessed in other functions. This is valid because the
   // interrupt vector table has static storage duration and will exist
   // throughout the duration of the application.
-  vector_table = p_vector_table.subspan(-core_interrupts);
+  state.vector_table = p_vector_table.subspan(-core_interrupts);
 
   // Relocate the interrupt vector table the vector buffer. By default this
   // will be set to the address of the start of flash memory for the MCU.
@@ -253,4 +902,141 @@ void initialize_interrupts(std::span<interrupt_pointer> p_vector_table)
 
   enable_all_interrupts();
 }
+
+void set_priority(irq_t p_irq, std::uint8_t p_priority)
+{
+  auto* field = priority_field(p_irq);
+
+  if (field == nullptr) {
+    return;
+  }
+
+  write_priority_field(field, p_priority);
+}
+
+std::uint8_t get_priority(irq_t p_irq)
+{
+  auto* field = priority_field(p_irq);
+
+  if (field == nullptr) {
+    return 0;
+  }
+
+  return read_priority_field(field);
+}
+
+void set_priority_grouping(std::uint8_t p_grouping)
+{
+  namespace aircr = application_interrupt_and_reset_control;
+
+  // The vector key field reads back as 0xFA05, so it must be replaced with
+  // the write key along with the new priority grouping.
+  auto aircr_value = hal::bit_value<std::uint32_t>(scb->aircr);
+  aircr_value.insert<aircr::priority_group>(p_grouping & 0b111U)
+    .insert<aircr::vector_key>(aircr::vector_key_value);
+
+  scb->aircr = aircr_value.get();
+}
+
+std::uint8_t get_priority_grouping()
+{
+  namespace aircr = application_interrupt_and_reset_control;
+  return static_cast<std::uint8_t>(
+    hal::bit_extract<aircr::priority_group>(scb->aircr));
+}
+
+void initialize_static_interrupts(std::span<interrupt_pointer const> p_vectors)
+{
+  auto& state = local_state();
+
+  // The vectors start at the non maskable interrupt, the two entries before it
+  // are the top of stack and reset vectors emitted by the linker script.
+  constexpr auto linker_provided_vectors =
+    hal::value(irq::non_maskable_interrupt) - core_interrupts;
+  constexpr auto vectors_before_irq_zero =
+    -hal::value(irq::non_maskable_interrupt);
+
+  // The vector table only contains handler addresses which are never written
+  // to through this span. The read only flag prevents any writes.
+  auto* irq_zero =
+    const_cast<interrupt_pointer*>(p_vectors.data()) + vectors_before_irq_zero;
+
+  if (state.vector_table.data() == irq_zero) {
+    return;
+  }
+
+  disable_all_interrupts();
+
+  state.vector_table = std::span<interrupt_pointer>(
+    irq_zero, p_vectors.size() - vectors_before_irq_zero);
+  state.vector_table_is_read_only = true;
+  state.instrumented_handlers = std::span<interrupt_pointer>();
+  state.interrupt_statistics = std::span<irq_statistics>();
+  state.irq_callbacks = std::span<irq_callback>();
+  state.callbacks_per_irq = 0;
+
+  auto const table_address =
+    reinterpret_cast<std::uintptr_t>(p_vectors.data()) -
+    (linker_provided_vectors * sizeof(interrupt_pointer));
+  set_interrupt_vector_table_address(reinterpret_cast<void*>(table_address));
+
+  enable_all_interrupts();
+}
+
+void initialize_interrupt_statistics(std::span<interrupt_pointer> p_handlers,
+                                     std::span<irq_statistics> p_statistics)
+{
+  auto& state = local_state();
+  if (not interrupt_vector_table_initialized() ||
+      state.vector_table_is_read_only ||
+      not state.instrumented_handlers.empty()) {
+    return;
+  }
+
+  auto const vector_count = state.vector_table.size() - core_interrupts;
+  if (p_handlers.size() < vector_count ||
+      p_statistics.size() < vector_count) {
+    return;
+  }
+
+  // Timing is based on the DWT cycle counter
+  core->demcr = (core->demcr | core_trace_enable);
+  dwt->ctrl = (dwt->ctrl | enable_cycle_count);
+
+  auto* vectors = state.vector_table.data() + core_interrupts;
+  auto const first_handler =
+    exception_number_of(hal::value(irq::non_maskable_interrupt));
+
+  auto const mask = mask_all_interrupts();
+
+  state.instrumented_handlers = p_handlers.first(vector_count);
+  state.interrupt_statistics = p_statistics.first(vector_count);
+  std::fill(state.interrupt_statistics.begin(),
+            state.interrupt_statistics.end(),
+            irq_statistics{});
+
+  for (auto i = first_handler; i < vector_count; i++) {
+    state.instrumented_handlers[i] = vectors[i];
+    if (is_instrumented(static_cast<irq_t>(i) + core_interrupts)) {
+      vectors[i] = instrumented_interrupt_handler;
+    }
+  }
+
+  restore_interrupt_mask(mask);
+}
+
+std::span<irq_statistics const> get_interrupt_statistics()
+{
+  return local_state().interrupt_statistics;
+}
+
+void reset_interrupt_statistics()
+{
+  auto& state = local_state();
+  auto const mask = mask_all_interrupts();
+  std::fill(state.interrupt_statistics.begin(),
+            state.interrupt_statistics.end(),
+            irq_statistics{});
+  restore_interrupt_mask(mask);
+}
 }  // namespace hal::cortex_m
@@ -0,0 +1,164 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/itm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "dwt_counter_reg.hpp"
+#include "itm_reg.hpp"
+
+#include <libhal-util/bit.hpp>
+#include <libhal/error.hpp>
+
+namespace hal::cortex_m {
+namespace {
+/// Bit 0 of a stimulus port reads as 1 when the port can accept a write
+constexpr std::uint32_t fifo_ready = 1U << 0U;
+
+void wait_for_fifo(std::uint8_t p_port)
+{
+  while ((itm->stim[p_port] & fifo_ready) == 0U) {
+    continue;
+  }
+}
+}  // namespace
+
+void initialize_itm(itm_settings const& p_settings)
+{
+  constexpr float max_prescaler = 1 << 16;
+  auto const prescaler = p_settings.trace_clock / p_settings.baud_rate;
+
+  if (not(prescaler >= 1.0f && prescaler <= max_prescaler)) {
+    hal::safe_throw(hal::argument_out_of_domain(nullptr));
+  }
+
+  // The ITM, DWT and TPIU are only accessible with the trace core enabled
+  core->demcr = (core->demcr | core_trace_enable);
+
+  // SWO is a single pin, asynchronous NRZ output at trace_clock / (ACPR + 1)
+  tpiu->cspsr = 1;
+  tpiu->sppr = swo_nrz_protocol;
+  tpiu->acpr = static_cast<std::uint32_t>(prescaler + 0.5f) - 1U;
+  tpiu->ffcr = formatter_bypass;
+
+  itm->lar = itm_unlock_key;
+  // Disable the ITM while its configuration is changed
+  itm->tcr = 0;
+  itm->tpr = 0;
+
+  if (p_settings.pc_sampling) {
+    // Sample every (POSTPRESET + 1) * 2^10 = 16,384 cycles
+    constexpr std::uint32_t divide_by_16 = 0xF;
+    constexpr std::uint32_t tap_cyccnt_bit_24 = 0b01;
+    hal::bit_modify(dwt->ctrl)
+      .set<dwt_control::cycle_count_enable>()
+      .set<dwt_sampling::cycle_tap>()
+      .insert<dwt_sampling::post_preset>(divide_by_16)
+      .insert<dwt_sampling::sync_tap>(tap_cyccnt_bit_24)
+      .set<dwt_sampling::pc_sample_enable>();
+  }
+
+  itm->ter[0] = p_settings.enabled_ports;
+
+  itm->tcr =
+    hal::bit_value<std::uint32_t>(0)
+      .set<itm_control::enable>()
+      .set<itm_control::sync_enable>()
+      .insert<itm_control::trace_bus_id>(1U)
+      .insert<itm_control::timestamp_enable>(
+        std::uint32_t{ p_settings.timestamps })
+      .insert<itm_control::dwt_forwarding_enable>(
+        std::uint32_t{ p_settings.pc_sampling })
+      .get();
+}
+
+bool itm_port_enabled(std::uint8_t p_port)
+{
+  constexpr std::uint8_t ports_per_register = 32;
+  auto const enabled_ports = itm->ter[p_port / ports_per_register];
+  auto const port_bit = 1U << (p_port % ports_per_register);
+
+  return hal::bit_extract<itm_control::enable>(itm->tcr) &&
+         (enabled_ports & port_bit) != 0U;
+}
+
+void itm_write(std::uint8_t p_port, std::uint32_t p_word)
+{
+  if (not itm_port_enabled(p_port)) {
+    return;
+  }
+
+  wait_for_fifo(p_port);
+  itm->stim[p_port] = p_word;
+}
+
+void itm_write_byte(std::uint8_t p_port, hal::byte p_byte)
+{
+  if (not itm_port_enabled(p_port)) {
+    return;
+  }
+
+  wait_for_fifo(p_port);
+  // The size of the store determines the size of the packet
+  *reinterpret_cast<std::uint8_t volatile*>(&itm->stim[p_port]) = p_byte;
+}
+
+itm_serial::itm_serial(std::uint8_t p_port)
+  : m_port(p_port)
+{
+}
+
+void itm_serial::driver_configure([[maybe_unused]] settings const& p_settings)
+{
+  // The SWO baud rate is shared by every stimulus port and is only set by
+  // initialize_itm().
+}
+
+serial::write_t itm_serial::driver_write(std::span<hal::byte const> p_data)
+{
+  if (not itm_port_enabled(m_port)) {
+    return { .data = p_data };
+  }
+
+  auto remaining = p_data;
+  while (remaining.size() >= sizeof(std::uint32_t)) {
+    std::uint32_t word = 0;
+    std::memcpy(&word, remaining.data(), sizeof(word));
+    wait_for_fifo(m_port);
+    itm->stim[m_port] = word;
+    remaining = remaining.subspan(sizeof(word));
+  }
+
+  for (auto const byte : remaining) {
+    itm_write_byte(m_port, byte);
+  }
+
+  return { .data = p_data };
+}
+
+serial::read_t itm_serial::driver_read(std::span<hal::byte> p_data)
+{
+  return { .data = p_data.first(0), .available = 0, .capacity = 0 };
+}
+
+void itm_serial::driver_flush()
+{
+  while (hal::bit_extract<itm_control::busy>(itm->tcr)) {
+    continue;
+  }
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,130 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <libhal-util/bit.hpp>
+
+namespace hal::cortex_m {
+/// Structure type to access the Instrumentation Trace Macrocell (ITM)
+struct itm_registers_t
+{
+  /// Offset: 0x000 ( /W)  Stimulus Port Registers. Reading a port returns 1
+  /// in bit 0 when the port can accept another write.
+  std::array<std::uint32_t volatile, 256> stim;
+  /// Reserved 0
+  std::array<std::uint32_t, 640> reserved0;
+  /// Offset: 0xE00 (R/W)  Trace Enable Registers
+  std::array<std::uint32_t volatile, 8> ter;
+  /// Reserved 1
+  std::array<std::uint32_t, 8> reserved1;
+  /// Offset: 0xE40 (R/W)  Trace Privilege Register
+  std::uint32_t volatile tpr;
+  /// Reserved 2
+  std::array<std::uint32_t, 15> reserved2;
+  /// Offset: 0xE80 (R/W)  Trace Control Register
+  std::uint32_t volatile tcr;
+  /// Reserved 3
+  std::array<std::uint32_t, 75> reserved3;
+  /// Offset: 0xFB0 ( /W)  Lock Access Register
+  std::uint32_t volatile lar;
+  /// Offset: 0xFB4 (R/ )  Lock Status Register
+  std::uint32_t const volatile lsr;
+};
+
+/// Structure type to access the Trace Port Interface Unit (TPIU)
+struct tpiu_registers_t
+{
+  /// Offset: 0x000 (R/ )  Supported Parallel Port Size Register
+  std::uint32_t const volatile sspsr;
+  /// Offset: 0x004 (R/W)  Current Parallel Port Size Register
+  std::uint32_t volatile cspsr;
+  /// Reserved 0
+  std::array<std::uint32_t, 2> reserved0;
+  /// Offset: 0x010 (R/W)  Asynchronous Clock Prescaler Register
+  std::uint32_t volatile acpr;
+  /// Reserved 1
+  std::array<std::uint32_t, 55> reserved1;
+  /// Offset: 0x0F0 (R/W)  Selected Pin Protocol Register
+  std::uint32_t volatile sppr;
+  /// Reserved 2
+  std::array<std::uint32_t, 131> reserved2;
+  /// Offset: 0x300 (R/ )  Formatter and Flush Status Register
+  std::uint32_t const volatile ffsr;
+  /// Offset: 0x304 (R/W)  Formatter and Flush Control Register
+  std::uint32_t volatile ffcr;
+};
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// ITM Trace Control Register (TCR).
+namespace itm_control {
+/// When set to 1, the ITM is enabled
+static constexpr auto enable = hal::bit_mask::from<0>();
+
+/// When set to 1, local timestamp packets are generated
+static constexpr auto timestamp_enable = hal::bit_mask::from<1>();
+
+/// When set to 1, synchronization packets are generated
+static constexpr auto sync_enable = hal::bit_mask::from<2>();
+
+/// When set to 1, packets generated by the DWT are forwarded to the ITM
+static constexpr auto dwt_forwarding_enable = hal::bit_mask::from<3>();
+
+/// Identifier of the ITM on the trace bus
+static constexpr auto trace_bus_id = hal::bit_mask::from<16, 22>();
+
+/// Reads as 1 while the ITM is transmitting packets
+static constexpr auto busy = hal::bit_mask::from<23>();
+}  // namespace itm_control
+
+/// Namespace containing the bit_mask objects that are used to configure PC
+/// sampling within the DWT Control Register (CTRL).
+namespace dwt_sampling {
+/// Reload value of the POSTCNT counter, which divides the CYCCNT tap
+static constexpr auto post_preset = hal::bit_mask::from<1, 4>();
+
+/// Selects the CYCCNT tap bit used to decrement POSTCNT, 0 = bit 6, 1 = bit 10
+static constexpr auto cycle_tap = hal::bit_mask::from<9>();
+
+/// Selects the CYCCNT tap bit used to generate synchronization packets
+static constexpr auto sync_tap = hal::bit_mask::from<10, 11>();
+
+/// When set to 1, periodic PC sample packets are generated
+static constexpr auto pc_sample_enable = hal::bit_mask::from<12>();
+}  // namespace dwt_sampling
+
+/// Value written to LAR to unlock writes to the ITM registers
+inline constexpr std::uint32_t itm_unlock_key = 0xC5AC'CE55;
+
+/// SPPR value that selects the asynchronous SWO NRZ (UART) protocol
+inline constexpr std::uint32_t swo_nrz_protocol = 0b10;
+
+/// FFCR value that bypasses the formatter, required for SWO output
+inline constexpr std::uint32_t formatter_bypass = 0x100;
+
+/// Address of the Cortex M ITM module
+inline constexpr intptr_t itm_address = 0xE000'0000UL;
+
+/// Address of the Cortex M TPIU module
+inline constexpr intptr_t tpiu_address = 0xE004'0000UL;
+
+/// Pointer to the Cortex M ITM module
+inline auto* itm = reinterpret_cast<itm_registers_t*>(itm_address);
+
+/// Pointer to the Cortex M TPIU module
+inline auto* tpiu = reinterpret_cast<tpiu_registers_t*>(tpiu_address);
+}  // namespace hal::cortex_m
@@ -0,0 +1,156 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if not defined(__arm__)
+#include <vector>
+
+#include <libhal-util/bit.hpp>
+#endif
+
+namespace hal::cortex_m {
+/// Direction of an access to a memory mapped register
+enum class mmio_operation : std::uint8_t
+{
+  read,
+  write,
+};
+
+/// A single access to a memory mapped register
+struct mmio_access
+{
+  /// Address of the register
+  std::uintptr_t address;
+  /// Width of the access in bytes
+  std::uint8_t width;
+  /// Whether the register was read or written
+  mmio_operation operation;
+};
+
+#if defined(__arm__)
+/// Type of a memory mapped register field within a register map
+template<typename T>
+using mmio = T volatile;
+#else
+/// When set, every access to an mmio register is appended to this log. Only
+/// available in host builds, where unit tests use it to count the register
+/// accesses made by a call.
+inline std::vector<mmio_access>* mmio_access_log = nullptr;
+
+/**
+ * @brief Memory mapped register which records its accesses
+ *
+ * Has the same size and layout as `T volatile`, such that register maps can
+ * be stubbed out with plain memory. Reads and writes are appended to
+ * `mmio_access_log` while it is set. Compound assignments are recorded as a
+ * read followed by a write, as they are on the device.
+ *
+ * @tparam T - integral type of the register
+ */
+template<typename T>
+class mmio_register
+{
+public:
+  mmio_register() = default;
+
+  mmio_register(mmio_register const& p_other)
+    : m_value(p_other.read())
+  {
+  }
+
+  mmio_register& operator=(mmio_register const& p_other)
+  {
+    write(p_other.read());
+    return *this;
+  }
+
+  mmio_register& operator=(T p_value)
+  {
+    write(p_value);
+    return *this;
+  }
+
+  operator T() const  // NOLINT
+  {
+    return read();
+  }
+
+  mmio_register& operator|=(T p_value)
+  {
+    write(read() | p_value);
+    return *this;
+  }
+
+  mmio_register& operator&=(T p_value)
+  {
+    write(read() & p_value);
+    return *this;
+  }
+
+  T read() const
+  {
+    record(mmio_operation::read);
+    return m_value;
+  }
+
+  void write(T p_value)
+  {
+    record(mmio_operation::write);
+    m_value = p_value;
+  }
+
+private:
+  void record(mmio_operation p_operation) const
+  {
+    if (mmio_access_log != nullptr) {
+      mmio_access_log->push_back({
+        .address = reinterpret_cast<std::uintptr_t>(&m_value),
+        .width = sizeof(T),
+        .operation = p_operation,
+      });
+    }
+  }
+
+  T volatile m_value{};
+};
+
+/// Type of a memory mapped register field within a register map
+template<typename T>
+using mmio = mmio_register<T>;
+#endif
+}  // namespace hal::cortex_m
+
+#if not defined(__arm__)
+namespace hal {
+/**
+ * @brief Extract a bit field from a recording register
+ *
+ * Allows `hal::bit_extract` to be called on registers of the host build as
+ * it is on the device. Records a single read.
+ *
+ * @tparam field - bit field to extract
+ * @param p_register - register to read
+ * @return auto - the value of the bit field
+ */
+template<bit_mask field, typename T>
+constexpr auto bit_extract(cortex_m::mmio_register<T> const& p_register)
+{
+  return bit_extract<field>(p_register.read());
+}
+}  // namespace hal
+#endif
@@ -0,0 +1,87 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/mpu.hpp>
+
+#include <cstdint>
+#include <span>
+
+#include <libhal-armcortex/system_control.hpp>
+
+#include "mpu_reg.hpp"
+
+#include <libhal-util/bit.hpp>
+#include <libhal/error.hpp>
+
+namespace hal::cortex_m {
+std::uint8_t mpu_region_count()
+{
+  return static_cast<std::uint8_t>(
+    hal::bit_extract<mpu_type::data_regions>(mpu->type));
+}
+
+void configure_mpu(std::span<mpu_region_registers const> p_regions,
+                   mpu_architecture p_architecture,
+                   bool p_privileged_default_map)
+{
+  auto const region_count = mpu_region_count();
+
+  if (p_regions.size() > region_count ||
+      p_architecture != native_mpu_architecture) {
+    hal::safe_throw(hal::argument_out_of_domain(nullptr));
+  }
+
+  disable_mpu();
+
+  if (p_architecture == mpu_architecture::armv8m) {
+    mpu->mair[0] = armv8m_mpu_attributes[0];
+    mpu->mair[1] = armv8m_mpu_attributes[1];
+  }
+
+  std::uint32_t region = 0;
+  for (auto const& registers : p_regions) {
+    mpu->rnr = region++;
+    mpu->rbar = registers.rbar;
+    mpu->rasr_or_rlar = registers.rasr_or_rlar;
+  }
+
+  // Regions left over from a previous configuration or the bootloader must not
+  // apply to the new memory map.
+  for (; region < region_count; region++) {
+    mpu->rnr = region;
+    mpu->rasr_or_rlar = 0;
+  }
+
+  auto control = hal::bit_value<std::uint32_t>(0)
+                   .set<mpu_control::enable>()
+                   .insert<mpu_control::privileged_default_map>(
+                     std::uint32_t{ p_privileged_default_map })
+                   .get();
+  mpu->ctrl = control;
+
+  // Ensure all subsequent memory accesses and instruction fetches use the new
+  // memory attributes.
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+void disable_mpu()
+{
+  // Complete any outstanding accesses using the current memory attributes
+  data_synchronization_barrier();
+  mpu->ctrl = 0;
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,73 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <libhal-util/bit.hpp>
+
+namespace hal::cortex_m {
+/// Structure type to access the Memory Protection Unit (MPU).
+///
+/// The ARMv7-M and ARMv8-M MPUs share this layout. ARMv8-M replaces the region
+/// attribute and size register (RASR) with the region limit address register
+/// (RLAR) and adds the memory attribute indirection registers (MAIR).
+struct mpu_registers_t
+{
+  /// Offset: 0x000 (R/ )  Type Register
+  std::uint32_t const volatile type;
+  /// Offset: 0x004 (R/W)  Control Register
+  std::uint32_t volatile ctrl;
+  /// Offset: 0x008 (R/W)  Region Number Register
+  std::uint32_t volatile rnr;
+  /// Offset: 0x00C (R/W)  Region Base Address Register
+  std::uint32_t volatile rbar;
+  /// Offset: 0x010 (R/W)  Region Attribute and Size Register (ARMv7-M) or
+  /// Region Limit Address Register (ARMv8-M)
+  std::uint32_t volatile rasr_or_rlar;
+  /// Offset: 0x014 (R/W)  RBAR and RASR/RLAR aliases 1 to 3
+  std::array<std::uint32_t volatile, 6> alias;
+  /// Reserved 0
+  std::array<std::uint32_t, 1> reserved0;
+  /// Offset: 0x030 (R/W)  Memory Attribute Indirection Registers 0 & 1
+  /// (ARMv8-M only)
+  std::array<std::uint32_t volatile, 2> mair;
+};
+
+/// Namespace containing the bit_mask objects that are used to read the MPU
+/// Type Register (TYPE).
+namespace mpu_type {
+/// Number of regions supported by the MPU
+static constexpr auto data_regions = hal::bit_mask::from<8, 15>();
+}  // namespace mpu_type
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// MPU Control Register (CTRL).
+namespace mpu_control {
+/// Enables the MPU
+static constexpr auto enable = hal::bit_mask::from<0>();
+/// Keep the MPU enabled during hard fault, NMI and FAULTMASK handlers
+static constexpr auto enable_in_fault_handlers = hal::bit_mask::from<1>();
+/// Use the default memory map as a background region for privileged accesses
+static constexpr auto privileged_default_map = hal::bit_mask::from<2>();
+}  // namespace mpu_control
+
+/// Address of the Cortex M MPU module
+inline constexpr intptr_t mpu_address = 0xE000'ED90UL;
+
+/// Pointer to the Cortex M MPU module
+inline auto* mpu = reinterpret_cast<mpu_registers_t*>(mpu_address);
+}  // namespace hal::cortex_m
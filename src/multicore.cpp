@@ -0,0 +1,53 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/multicore.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+#include <libhal-armcortex/system_control.hpp>
+
+namespace hal::cortex_m {
+void signal_cores()
+{
+  data_synchronization_barrier();
+  send_event();
+}
+
+void core_doorbell::ring()
+{
+  // Only the ringing core writes the count, so no read-modify-write is needed
+  auto const rings = m_rings.load(std::memory_order_relaxed);
+  m_rings.store(rings + 1, std::memory_order_release);
+  signal_cores();
+}
+
+bool core_doorbell::answer()
+{
+  auto const rings = m_rings.load(std::memory_order_acquire);
+  if (rings == m_answered) {
+    return false;
+  }
+  m_answered = rings;
+  return true;
+}
+
+void core_doorbell::wait()
+{
+  while (not answer()) {
+    wait_for_event();
+  }
+}
+}  // namespace hal::cortex_m
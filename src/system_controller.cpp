@@ -14,17 +14,271 @@
 
 #include <libhal-armcortex/system_control.hpp>
 
+#include <cstdint>
+#include <span>
+
 #include "system_controller_reg.hpp"
 
+#include <libhal-util/bit.hpp>
 #include <libhal/error.hpp>
 
 namespace hal::cortex_m {
+namespace {
+struct data_cache_geometry
+{
+  std::uint32_t sets;
+  std::uint32_t ways;
+};
+
+data_cache_geometry get_data_cache_geometry()
+{
+  // Select the L1 data cache
+  scb->csselr = 0;
+  data_synchronization_barrier();
+
+  std::uint32_t const ccsidr = scb->ccsidr;
+  return {
+    .sets = hal::bit_extract<cache_size_id::number_of_sets>(ccsidr) + 1,
+    .ways = hal::bit_extract<cache_size_id::associativity>(ccsidr) + 1,
+  };
+}
+
+/// Apply a set/way maintenance operation to every line of the data cache
+void for_each_data_cache_line(mmio<std::uint32_t>& p_operation_register)
+{
+  auto const geometry = get_data_cache_geometry();
+
+  for (std::uint32_t set = 0; set < geometry.sets; set++) {
+    for (std::uint32_t way = 0; way < geometry.ways; way++) {
+      p_operation_register = hal::bit_value<std::uint32_t>(0)
+                               .insert<cache_set_way::set>(set)
+                               .insert<cache_set_way::way>(way)
+                               .get();
+    }
+  }
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+/// Apply an address based maintenance operation to every line of a region
+void for_each_line_in(mmio<std::uint32_t>& p_operation_register,
+                      std::uintptr_t p_start,
+                      std::uintptr_t p_end)
+{
+  data_synchronization_barrier();
+
+  for (auto line = p_start; line < p_end; line += cache_line_size) {
+    p_operation_register = static_cast<std::uint32_t>(line);
+  }
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+bool larger_than_data_cache(std::size_t p_size)
+{
+  auto const geometry = get_data_cache_geometry();
+  return p_size > (geometry.sets * geometry.ways * cache_line_size);
+}
+
+std::uintptr_t align_down_to_line(std::uintptr_t p_address)
+{
+  return p_address & ~std::uintptr_t{ cache_line_size - 1 };
+}
+
+std::uintptr_t align_up_to_line(std::uintptr_t p_address)
+{
+  return align_down_to_line(p_address + cache_line_size - 1);
+}
+}  // namespace
+
 void initialize_floating_point_unit()
 {
   scb->cpacr = scb->cpacr | ((0b11 << 10 * 2) | /* set CP10 Full Access */
                              (0b11 << 11 * 2)); /* set CP11 Full Access */
 }
 
+void set_floating_point_stacking(floating_point_stacking p_stacking)
+{
+  namespace fpccr = floating_point_context_control;
+
+  auto const automatic =
+    static_cast<std::uint32_t>(p_stacking != floating_point_stacking::none);
+  auto const lazy =
+    static_cast<std::uint32_t>(p_stacking == floating_point_stacking::lazy);
+
+  hal::bit_modify(fpu->fpccr)
+    .insert<fpccr::automatic_state_enable>(automatic)
+    .insert<fpccr::lazy_state_enable>(lazy);
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+floating_point_stacking get_floating_point_stacking()
+{
+  namespace fpccr = floating_point_context_control;
+
+  auto const fpccr_value = fpu->fpccr;
+  if (not hal::bit_extract<fpccr::automatic_state_enable>(fpccr_value)) {
+    return floating_point_stacking::none;
+  }
+  if (hal::bit_extract<fpccr::lazy_state_enable>(fpccr_value)) {
+    return floating_point_stacking::lazy;
+  }
+  return floating_point_stacking::always;
+}
+
+bool lazy_floating_point_save_pending()
+{
+  return hal::bit_extract<floating_point_context_control::lazy_state_active>(
+           fpu->fpccr) != 0U;
+}
+
+void enable_instruction_cache()
+{
+  if (hal::bit_extract<configuration_control::instruction_cache_enable>(
+        scb->ccr)) {
+    return;
+  }
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+  scb->iciallu = 0;
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+
+  scb->ccr = hal::bit_value<std::uint32_t>(scb->ccr)
+               .set<configuration_control::instruction_cache_enable>()
+               .get();
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+void disable_instruction_cache()
+{
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+
+  scb->ccr = hal::bit_value<std::uint32_t>(scb->ccr)
+               .clear<configuration_control::instruction_cache_enable>()
+               .get();
+  scb->iciallu = 0;
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+void enable_data_cache()
+{
+  if (hal::bit_extract<configuration_control::data_cache_enable>(scb->ccr)) {
+    return;
+  }
+
+  // The contents of the cache are unknown out of reset and must be
+  // invalidated before the cache is enabled.
+  for_each_data_cache_line(scb->dcisw);
+
+  scb->ccr = hal::bit_value<std::uint32_t>(scb->ccr)
+               .set<configuration_control::data_cache_enable>()
+               .get();
+
+  data_synchronization_barrier();
+  instruction_synchronization_barrier();
+}
+
+void disable_data_cache()
+{
+  scb->ccr = hal::bit_value<std::uint32_t>(scb->ccr)
+               .clear<configuration_control::data_cache_enable>()
+               .get();
+  data_synchronization_barrier();
+
+  // Write back any dirty lines now that no new lines can be allocated
+  for_each_data_cache_line(scb->dccisw);
+}
+
+void clean_dcache(std::span<hal::byte const> p_memory)
+{
+  if (p_memory.empty()) {
+    return;
+  }
+
+  if (larger_than_data_cache(p_memory.size())) {
+    for_each_data_cache_line(scb->dccsw);
+    return;
+  }
+
+  auto const start = reinterpret_cast<std::uintptr_t>(p_memory.data());
+  for_each_line_in(scb->dccmvac,
+                   align_down_to_line(start),
+                   align_up_to_line(start + p_memory.size()));
+}
+
+void invalidate_dcache(std::span<hal::byte> p_memory)
+{
+  if (p_memory.empty()) {
+    return;
+  }
+
+  if (larger_than_data_cache(p_memory.size())) {
+    for_each_data_cache_line(scb->dccisw);
+    return;
+  }
+
+  auto const start = reinterpret_cast<std::uintptr_t>(p_memory.data());
+  auto const end = start + p_memory.size();
+  auto first_full_line = align_up_to_line(start);
+  auto last_full_line = align_down_to_line(end);
+
+  // Lines partially covered by the region may hold data belonging to other
+  // objects, so those are written back before they are discarded.
+  if (first_full_line != start) {
+    for_each_line_in(scb->dccimvac, align_down_to_line(start), first_full_line);
+  }
+
+  if (last_full_line != end && last_full_line >= first_full_line) {
+    for_each_line_in(scb->dccimvac, last_full_line, align_up_to_line(end));
+  }
+
+  if (first_full_line < last_full_line) {
+    for_each_line_in(scb->dcimvac, first_full_line, last_full_line);
+  }
+}
+
+void clean_invalidate_dcache(std::span<hal::byte> p_memory)
+{
+  if (p_memory.empty()) {
+    return;
+  }
+
+  if (larger_than_data_cache(p_memory.size())) {
+    for_each_data_cache_line(scb->dccisw);
+    return;
+  }
+
+  auto const start = reinterpret_cast<std::uintptr_t>(p_memory.data());
+  for_each_line_in(scb->dccimvac,
+                   align_down_to_line(start),
+                   align_up_to_line(start + p_memory.size()));
+}
+
+void data_synchronization_barrier()
+{
+#if defined(__arm__)
+  asm volatile("dsb 0xF" : : : "memory");
+#endif
+}
+
+void instruction_synchronization_barrier()
+{
+#if defined(__arm__)
+  asm volatile("isb 0xF" : : : "memory");
+#endif
+}
+
 void set_interrupt_vector_table_address(void* p_table_location)
 {
   // Relocate the interrupt vector table the vector buffer. By default this
@@ -36,7 +290,7 @@ void* get_interrupt_vector_table_address()
 {
   // Relocate the interrupt vector table the vector buffer. By default this
   // will be set to the address of the start of flash memory for the MCU.
-  return reinterpret_cast<void*>(scb->vtor);  // NOLINT
+  return reinterpret_cast<void*>(static_cast<intptr_t>(scb->vtor));  // NOLINT
 }
 
 void reset()
@@ -63,4 +317,37 @@ void wait_for_event()
   asm volatile("wfe");
 #endif
 }
+
+void send_event()
+{
+#if defined(__arm__)
+  asm volatile("sev");
+#endif
+}
+
+bool stack_limit_supported()
+{
+#if defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8M_BASE__) ||         \
+  defined(__ARM_ARCH_8_1M_MAIN__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void set_main_stack_limit([[maybe_unused]] void const* p_limit)
+{
+#if defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8M_BASE__) ||         \
+  defined(__ARM_ARCH_8_1M_MAIN__)
+  asm volatile("msr msplim, %0" : : "r"(p_limit) : "memory");
+#endif
+}
+
+void set_process_stack_limit([[maybe_unused]] void const* p_limit)
+{
+#if defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8M_BASE__) ||         \
+  defined(__ARM_ARCH_8_1M_MAIN__)
+  asm volatile("msr psplim, %0" : : "r"(p_limit) : "memory");
+#endif
+}
 }  // namespace hal::cortex_m
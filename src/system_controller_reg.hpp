@@ -17,54 +17,245 @@
 #include <array>
 #include <cstdint>
 
+#include <libhal-util/bit.hpp>
+
+#include "mmio.hpp"
+
 namespace hal::cortex_m {
 /// Structure type to access the System Control Block (SCB).
 struct scb_registers_t
 {
   /// Offset: 0x000 (R/ )  CPUID Base Register
-  uint32_t const volatile cpuid;
+  mmio<uint32_t> const cpuid;
   /// Offset: 0x004 (R/W)  Interrupt Control and State Register
-  uint32_t volatile icsr;
+  mmio<uint32_t> icsr;
   /// Offset: 0x008 (R/W)  Vector Table Offset Register
-  intptr_t volatile vtor;
+  mmio<intptr_t> vtor;
   /// Offset: 0x00C (R/W)  Application Interrupt and Reset Control Register
-  uint32_t volatile aircr;
+  mmio<uint32_t> aircr;
   /// Offset: 0x010 (R/W)  System Control Register
-  uint32_t volatile scr;
+  mmio<uint32_t> scr;
   /// Offset: 0x014 (R/W)  Configuration Control Register
-  uint32_t volatile ccr;
+  mmio<uint32_t> ccr;
   /// Offset: 0x018 (R/W)  System Handlers Priority Registers (4-7, 8-11, 5)
-  std::array<uint8_t volatile, 12U> shp;
+  std::array<mmio<uint8_t>, 12U> shp;
   /// Offset: 0x024 (R/W)  System Handler Control and State Register
-  uint32_t volatile shcsr;
+  mmio<uint32_t> shcsr;
   /// Offset: 0x028 (R/W)  Configurable Fault Status Register
-  uint32_t volatile cfsr;
+  mmio<uint32_t> cfsr;
   /// Offset: 0x02C (R/W)  HardFault Status Register
-  uint32_t volatile hfsr;
+  mmio<uint32_t> hfsr;
   /// Offset: 0x030 (R/W)  Debug Fault Status Register
-  uint32_t volatile dfsr;
+  mmio<uint32_t> dfsr;
   /// Offset: 0x034 (R/W)  MemManage Fault Address Register
-  uint32_t volatile mmfar;
+  mmio<uint32_t> mmfar;
   /// Offset: 0x038 (R/W)  BusFault Address Register
-  uint32_t volatile bfar;
+  mmio<uint32_t> bfar;
   /// Offset: 0x03C (R/W)  Auxiliary Fault Status Register
-  uint32_t volatile afsr;
+  mmio<uint32_t> afsr;
   /// Offset: 0x040 (R/ )  Processor Feature Register
-  std::array<uint32_t volatile, 2U> const pfr;
+  std::array<mmio<uint32_t>, 2U> const pfr;
   /// Offset: 0x048 (R/ )  Debug Feature Register
-  uint32_t const volatile dfr;
+  mmio<uint32_t> const dfr;
   /// Offset: 0x04C (R/ )  Auxiliary Feature Register
-  uint32_t const volatile adr;
+  mmio<uint32_t> const adr;
   /// Offset: 0x050 (R/ )  Memory Model Feature Register
-  std::array<uint32_t volatile, 4U> const mmfr;
+  std::array<mmio<uint32_t>, 4U> const mmfr;
   /// Offset: 0x060 (R/ )  Instruction Set Attributes Register
-  std::array<uint32_t volatile, 5U> const isar;
+  std::array<mmio<uint32_t>, 5U> const isar;
   /// Reserved 0
-  std::array<uint32_t, 5U> reserved0;
+  std::array<uint32_t, 1U> reserved0;
+  /// Offset: 0x078 (R/ )  Cache Level ID register
+  mmio<uint32_t> const clidr;
+  /// Offset: 0x07C (R/ )  Cache Type register
+  mmio<uint32_t> const ctr;
+  /// Offset: 0x080 (R/ )  Cache Size ID Register
+  mmio<uint32_t> const ccsidr;
+  /// Offset: 0x084 (R/W)  Cache Size Selection Register
+  mmio<uint32_t> csselr;
   /// Offset: 0x088 (R/W)  Coprocessor Access Control Register
-  uint32_t volatile cpacr;
+  mmio<uint32_t> cpacr;
+  /// Reserved 1
+  std::array<uint32_t, 93U> reserved1;
+  /// Offset: 0x200 ( /W)  Software Triggered Interrupt Register
+  mmio<uint32_t> stir;
+  /// Reserved 2
+  std::array<uint32_t, 15U> reserved2;
+  /// Offset: 0x240 (R/ )  Media and VFP Feature Register 0
+  mmio<uint32_t> const mvfr0;
+  /// Offset: 0x244 (R/ )  Media and VFP Feature Register 1
+  mmio<uint32_t> const mvfr1;
+  /// Offset: 0x248 (R/ )  Media and VFP Feature Register 2
+  mmio<uint32_t> const mvfr2;
+  /// Reserved 3
+  std::array<uint32_t, 1U> reserved3;
+  /// Offset: 0x250 ( /W)  I-Cache Invalidate All to PoU
+  mmio<uint32_t> iciallu;
+  /// Reserved 4
+  std::array<uint32_t, 1U> reserved4;
+  /// Offset: 0x258 ( /W)  I-Cache Invalidate by MVA to PoU
+  mmio<uint32_t> icimvau;
+  /// Offset: 0x25C ( /W)  D-Cache Invalidate by MVA to PoC
+  mmio<uint32_t> dcimvac;
+  /// Offset: 0x260 ( /W)  D-Cache Invalidate by Set-way
+  mmio<uint32_t> dcisw;
+  /// Offset: 0x264 ( /W)  D-Cache Clean by MVA to PoU
+  mmio<uint32_t> dccmvau;
+  /// Offset: 0x268 ( /W)  D-Cache Clean by MVA to PoC
+  mmio<uint32_t> dccmvac;
+  /// Offset: 0x26C ( /W)  D-Cache Clean by Set-way
+  mmio<uint32_t> dccsw;
+  /// Offset: 0x270 ( /W)  D-Cache Clean and Invalidate by MVA to PoC
+  mmio<uint32_t> dccimvac;
+  /// Offset: 0x274 ( /W)  D-Cache Clean and Invalidate by Set-way
+  mmio<uint32_t> dccisw;
 };
 
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// Interrupt Control and State Register (ICSR).
+namespace interrupt_control_state {
+/// Exception number of the currently executing exception, 0 in thread mode
+static constexpr auto vector_active = hal::bit_mask::from<0, 8>();
+
+/// Writing 1 to this bit clears the pending state of the SysTick exception
+static constexpr auto pend_systick_clear = hal::bit_mask::from<25>();
+
+/// Reads as 1 when the SysTick exception is pending, writing 1 pends it
+static constexpr auto pend_systick_set = hal::bit_mask::from<26>();
+
+/// Writing 1 to this bit clears the pending state of the PendSV exception
+static constexpr auto pend_sv_clear = hal::bit_mask::from<27>();
+
+/// Reads as 1 when the PendSV exception is pending, writing 1 pends it
+static constexpr auto pend_sv_set = hal::bit_mask::from<28>();
+}  // namespace interrupt_control_state
+
+/// Namespace containing the bit_mask objects that are used to read the
+/// System Handler Control and State Register (SHCSR).
+namespace system_handler_control_state {
+/// Reads as 1 when the PendSV exception is active
+static constexpr auto pend_sv_active = hal::bit_mask::from<10>();
+
+/// Reads as 1 when the SysTick exception is active
+static constexpr auto systick_active = hal::bit_mask::from<11>();
+}  // namespace system_handler_control_state
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// System Control Register (SCR).
+namespace system_control {
+/// When set to 1, the processor sleeps again on return from an exception to
+/// thread mode, rather than resuming thread mode.
+static constexpr auto sleep_on_exit = hal::bit_mask::from<1>();
+
+/// When set to 1, sleep instructions enter deep sleep rather than sleep
+static constexpr auto sleep_deep = hal::bit_mask::from<2>();
+
+/// When set to 1, an interrupt becoming pending, even if disabled, is a wake up
+/// event for WFE.
+static constexpr auto send_event_on_pending = hal::bit_mask::from<4>();
+}  // namespace system_control
+
+/// Namespace containing the bit_mask objects that are used to read the
+/// Configurable Fault Status Register (CFSR).
+namespace configurable_fault_status {
+/// Set when a MemManage fault occurred while stacking on exception entry
+static constexpr auto memory_stacking_error = hal::bit_mask::from<4>();
+
+/// Set when a BusFault occurred while stacking on exception entry
+static constexpr auto bus_stacking_error = hal::bit_mask::from<12>();
+
+/// Set when a stack pointer dropped below its ARMv8-M stack limit
+static constexpr auto stack_overflow = hal::bit_mask::from<20>();
+}  // namespace configurable_fault_status
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// Configuration Control Register (CCR).
+namespace configuration_control {
+/// When set to 1, the L1 data cache is enabled
+static constexpr auto data_cache_enable = hal::bit_mask::from<16>();
+
+/// When set to 1, the L1 instruction cache is enabled
+static constexpr auto instruction_cache_enable = hal::bit_mask::from<17>();
+}  // namespace configuration_control
+
+/// Namespace containing the bit_mask objects that are used to read the Cache
+/// Size ID Register (CCSIDR).
+namespace cache_size_id {
+/// log2(number of words in a cache line) - 2
+static constexpr auto line_size = hal::bit_mask::from<0, 2>();
+
+/// Associativity of the cache minus 1
+static constexpr auto associativity = hal::bit_mask::from<3, 12>();
+
+/// Number of sets in the cache minus 1
+static constexpr auto number_of_sets = hal::bit_mask::from<13, 27>();
+}  // namespace cache_size_id
+
+/// Namespace containing the bit_mask objects for the D-Cache set/way
+/// maintenance registers (DCISW, DCCSW & DCCISW) of the Cortex M7.
+namespace cache_set_way {
+/// Set to operate on
+static constexpr auto set = hal::bit_mask::from<5, 13>();
+
+/// Way to operate on
+static constexpr auto way = hal::bit_mask::from<30, 31>();
+}  // namespace cache_set_way
+
+/// Size of a Cortex M7 L1 cache line in bytes
+inline constexpr std::uint32_t cache_line_size = 32;
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// Application Interrupt and Reset Control Register (AIRCR).
+namespace application_interrupt_and_reset_control {
+/// Writing 1 to this bit requests a system reset.
+static constexpr auto system_reset_request = hal::bit_mask::from<2>();
+
+/// Priority grouping field, determines the split between group priority and
+/// subpriority of each interrupt priority field.
+static constexpr auto priority_group = hal::bit_mask::from<8, 10>();
+
+/// Register key field. Writes to AIRCR are ignored unless `vector_key_value`
+/// is written to this field.
+static constexpr auto vector_key = hal::bit_mask::from<16, 31>();
+
+/// Value that must be written to the vector_key field for a write to AIRCR
+/// to take effect.
+static constexpr std::uint32_t vector_key_value = 0x5FA;
+}  // namespace application_interrupt_and_reset_control
+
+/// Structure type to access the floating point context control registers
+struct fpu_registers_t
+{
+  /// Offset: 0x000 (R/W)  Floating-Point Context Control Register
+  uint32_t volatile fpccr;
+  /// Offset: 0x004 (R/W)  Floating-Point Context Address Register
+  uint32_t volatile fpcar;
+  /// Offset: 0x008 (R/W)  Floating-Point Default Status Control Register
+  uint32_t volatile fpdscr;
+};
+
+/// Namespace containing the bit_mask objects that are used to manipulate the
+/// Floating-Point Context Control Register (FPCCR).
+namespace floating_point_context_control {
+/// Reads as 1 when space for floating point state has been reserved on the
+/// stack but the state has not been saved yet.
+static constexpr auto lazy_state_active = hal::bit_mask::from<0>();
+
+/// When set to 1, the floating point state is saved lazily, the first time
+/// the exception executes a floating point instruction.
+static constexpr auto lazy_state_enable = hal::bit_mask::from<30>();
+
+/// When set to 1, exception entry saves the floating point state of contexts
+/// which have used floating point.
+static constexpr auto automatic_state_enable = hal::bit_mask::from<31>();
+}  // namespace floating_point_context_control
+
+/// Floating point context control registers address
+inline constexpr intptr_t fpu_address = 0xE000'EF34UL;
+
+/// @return auto* - Address of the floating point context control registers
+inline auto* fpu = reinterpret_cast<fpu_registers_t*>(fpu_address);
+
 /// System control block address
 inline constexpr intptr_t scb_address = 0xE000'ED00UL;
 
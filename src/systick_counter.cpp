@@ -0,0 +1,246 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/systick_counter.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/bit.hpp>
+#include <libhal-util/static_callable.hpp>
+#include <libhal/error.hpp>
+
+#include "system_controller_reg.hpp"
+#include "systick_timer_reg.hpp"
+
+namespace hal::cortex_m {
+namespace {
+/// Largest value that fits within the 24-bit reload register
+constexpr std::uint32_t maximum_reload = 0x00FF'FFFF;
+/// Shortest period programmed for a deadline, in clock cycles. Keeps the
+/// interrupt from being pended again before it has finished running.
+constexpr std::uint64_t minimum_period = 256;
+/// Delays are clamped to this many nanoseconds, over 146 years, so that the
+/// conversion to clock cycles cannot overflow.
+constexpr std::int64_t maximum_delay = std::int64_t{ 1 } << 62;
+
+bool wrap_pending()
+{
+  return hal::bit_extract<interrupt_control_state::pend_systick_set>(
+    scb->icsr);
+}
+
+/**
+ * @brief Reload value for a period as close to p_cycles long as possible
+ *
+ */
+std::uint32_t reload_for(std::uint64_t p_cycles)
+{
+  auto const period = std::clamp<std::uint64_t>(
+    p_cycles, minimum_period, std::uint64_t{ maximum_reload } + 1);
+  return static_cast<std::uint32_t>(period - 1);
+}
+}  // namespace
+
+systick_counter::systick_counter(hertz p_frequency, clock_source p_source)
+  : m_reload(maximum_reload)
+  , m_frequency(p_frequency)
+  , m_nanoseconds_to_cycles(frequency_scale::nanoseconds_to_cycles(p_frequency))
+{
+  if (not interrupt_vector_table_initialized()) {
+    hal::safe_throw(hal::operation_not_permitted(this));
+  }
+
+  sys_tick->control = 0;
+
+  auto handler = static_callable<systick_counter, 0, void(void)>(
+    [this]() { handle_interrupt(); });
+  enable_interrupt(irq::systick, handler.get_handler());
+  // Exception entry clears the pending bit before the interrupt has added the
+  // period to the elapsed count. Nothing that reads the uptime may preempt the
+  // interrupt in between, so it must be the most urgent configurable one.
+  set_priority(irq::systick, 0);
+
+  sys_tick->reload = maximum_reload;
+  sys_tick->current_value = 0;
+
+  sys_tick->control = hal::bit_value<std::uint32_t>(0)
+                        .set<systick_control_register::enable_interrupt>()
+                        .insert<systick_control_register::clock_source>(
+                          static_cast<std::uint32_t>(p_source))
+                        .set<systick_control_register::enable_counter>()
+                        .get();
+}
+
+systick_counter::~systick_counter()
+{
+  sys_tick->control = 0;
+  disable_interrupt(irq::systick);
+}
+
+std::uint64_t systick_counter::driver_uptime()
+{
+  critical_section lock;
+  return uptime_locked();
+}
+
+hal::hertz systick_counter::driver_frequency()
+{
+  return m_frequency;
+}
+
+bool systick_counter::driver_is_running()
+{
+  critical_section lock;
+  return m_scheduled;
+}
+
+void systick_counter::driver_cancel()
+{
+  critical_section lock;
+  // A wrap that is pending already reloaded from the current reload value, so
+  // it must be accounted for before the reload value is replaced.
+  service_pending_wrap();
+  m_scheduled = false;
+  // The current period runs to its end, the periods after it are full length
+  sys_tick->reload = maximum_reload;
+}
+
+void systick_counter::driver_schedule(hal::callback<void(void)> p_callback,
+                                      hal::time_duration p_delay)
+{
+  std::uint64_t cycles = 0;
+  if (p_delay.count() > 0) {
+    auto const delay = std::min(p_delay.count(), maximum_delay);
+    cycles = m_nanoseconds_to_cycles.scale(static_cast<std::uint64_t>(delay));
+  }
+
+  critical_section lock;
+  service_pending_wrap();
+  m_callback = p_callback;
+  m_deadline = uptime_locked() + cycles;
+  m_scheduled = true;
+  program_period();
+}
+
+std::uint64_t systick_counter::uptime_locked()
+{
+  auto current = sys_tick->current_value;
+
+  // The counter wrapped but the interrupt has not run yet, because interrupts
+  // are masked or a higher priority interrupt is running. The current value
+  // may have been read before or after the wrap, so it is read again to be
+  // sure it is from after the wrap.
+  if (wrap_pending()) {
+    current = sys_tick->current_value;
+    auto const period_end = m_elapsed + m_reload + 1;
+    // A value of 0 is the last cycle before the reload
+    if (current == 0) {
+      return period_end - 1;
+    }
+    return period_end + (sys_tick->reload - current);
+  }
+
+  // A value of 0 without a pending wrap only occurs right after the counter
+  // was cleared, the cycle before the current period's reload.
+  if (current == 0) {
+    return m_elapsed == 0 ? 0 : m_elapsed - 1;
+  }
+
+  return m_elapsed + (m_reload - current);
+}
+
+void systick_counter::service_pending_wrap()
+{
+  if (wrap_pending()) {
+    end_period();
+    scb->icsr = hal::bit_value<std::uint32_t>(0)
+                  .set<interrupt_control_state::pend_systick_clear>()
+                  .get();
+  }
+}
+
+void systick_counter::end_period()
+{
+  m_elapsed += std::uint64_t{ m_reload } + 1;
+  // The reload register is only reprogrammed with the wrap serviced, so it
+  // holds the value that the new period started from.
+  m_reload = sys_tick->reload;
+}
+
+void systick_counter::program_period()
+{
+  auto const period_end = m_elapsed + m_reload + 1;
+
+  // With the deadline on the end of the current period, the interrupt calls the
+  // callback and programs the period after it.
+  if (not m_scheduled || m_deadline == period_end) {
+    sys_tick->reload = maximum_reload;
+    return;
+  }
+
+  // End a following period on the deadline
+  if (m_deadline > period_end) {
+    sys_tick->reload = reload_for(m_deadline - period_end);
+    return;
+  }
+
+  // The deadline lands within the current period, so the interrupt will run on
+  // time or late. The period after the deadline is full length, as the
+  // interrupt reprograms it once the callback has run.
+  sys_tick->reload = maximum_reload;
+
+  auto const current = sys_tick->current_value;
+  // The period is ending anyway, and the interrupt will program the next one
+  if (current == 0 || wrap_pending()) {
+    return;
+  }
+
+  auto const now = m_elapsed + (m_reload - current);
+  auto const remaining = m_deadline > now ? m_deadline - now : 0;
+  auto const reload = reload_for(remaining);
+
+  // Restarting the counter only helps if the new period ends sooner
+  if (now + reload + 2 >= period_end) {
+    return;
+  }
+
+  // Clearing the counter reloads it on the next clock cycle. The cycles that
+  // tick between reading and clearing the counter are lost.
+  sys_tick->reload = reload;
+  sys_tick->current_value = 0;
+  m_elapsed = now + 1;
+  m_reload = reload;
+}
+
+void systick_counter::handle_interrupt()
+{
+  bool expired = false;
+
+  {
+    critical_section lock;
+    end_period();
+    if (m_scheduled && uptime_locked() >= m_deadline) {
+      m_scheduled = false;
+      expired = true;
+    }
+    program_period();
+  }
+
+  if (expired) {
+    m_callback();
+  }
+}
+}  // namespace hal::cortex_m
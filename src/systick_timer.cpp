@@ -14,18 +14,43 @@
 
 #include <libhal-armcortex/systick_timer.hpp>
 
+#include <algorithm>
 #include <cstdint>
 
+#include <libhal-armcortex/frequency_scale.hpp>
 #include <libhal-armcortex/interrupt.hpp>
 #include <libhal-util/bit.hpp>
 #include <libhal-util/static_callable.hpp>
-#include <libhal-util/units.hpp>
 #include <libhal/error.hpp>
 #include <libhal/functional.hpp>
 
+#include "system_controller_reg.hpp"
 #include "systick_timer_reg.hpp"
 
 namespace hal::cortex_m {
+namespace {
+/// Largest value that fits within the 24-bit reload register
+constexpr std::uint64_t maximum_reload = 0x00FF'FFFF;
+
+std::uint64_t cycles_for(frequency_scale const& p_nanoseconds_to_cycles,
+                         hal::time_duration p_delay)
+{
+  if (p_delay.count() <= 0) {
+    return 1;
+  }
+  auto const cycle_count = p_nanoseconds_to_cycles.scale(
+    static_cast<std::uint64_t>(p_delay.count()));
+  if (cycle_count <= 1) {
+    return 1;
+  }
+  return cycle_count;
+}
+
+std::uint64_t periods_for(std::uint64_t p_cycle_count)
+{
+  return (p_cycle_count + maximum_reload - 1) / maximum_reload;
+}
+}  // namespace
 
 void start()
 {
@@ -53,6 +78,9 @@ void systick_timer::register_cpu_frequency(hertz p_frequency,
 {
   stop();
   m_frequency = p_frequency;
+  m_nanoseconds_to_cycles = frequency_scale::nanoseconds_to_cycles(p_frequency);
+  m_source = p_source;
+  m_periods_remaining = 0;
 
   // Since reloads only occur when the current_value falls from 1 to 0,
   // setting this register directly to zero from any other number will disable
@@ -74,10 +102,17 @@ void systick_timer::register_cpu_frequency(hertz p_frequency,
   sys_tick->control = control.get();
 }
 
+void systick_timer::register_external_clock_frequency(hertz p_frequency)
+{
+  m_external_frequency = p_frequency;
+  m_external_nanoseconds_to_cycles =
+    frequency_scale::nanoseconds_to_cycles(p_frequency);
+}
+
 systick_timer::~systick_timer()
 {
   stop();
-  disable_interrupt(event_number);
+  disable_interrupt(irq::systick);
 }
 
 bool systick_timer::driver_is_running()
@@ -93,36 +128,78 @@ void systick_timer::driver_cancel()
   // All that is needed is to stop the timer. When the timer is started again
   // via `schedule()`, the timer value will be reloaded/reset.
   stop();
+  m_periods_remaining = 0;
 }
 
 void systick_timer::driver_schedule(hal::callback<void(void)> p_callback,
                                     hal::time_duration p_delay)
 {
-  constexpr std::int64_t maximum = 0x00FFFFFF;
-
-  auto cycle_count = cycles_per(m_frequency, p_delay);
-  if (cycle_count <= 1) {
-    cycle_count = 1;
-  } else if (cycle_count > maximum) {
-    throw std::errc::invalid_argument;
+  auto source = m_source;
+  auto cycle_count = cycles_for(m_nanoseconds_to_cycles, p_delay);
+
+  if (source == clock_source::processor && m_external_frequency > 0.0f &&
+      cycle_count > maximum_reload) {
+    auto const external_cycle_count =
+      cycles_for(m_external_nanoseconds_to_cycles, p_delay);
+    if (periods_for(external_cycle_count) < periods_for(cycle_count)) {
+      cycle_count = external_cycle_count;
+      source = clock_source::external;
+    }
   }
 
-  // Stop the previously scheduled event
+  // Split the delay into equal periods that each fit within the 24-bit reload
+  // register. The reload value stays the same for every period, so there is
+  // nothing to reprogram within the interrupt. SysTick counts reload + 1
+  // cycles per period, and a reload of 0 would stop it, so each period is at
+  // least 2 cycles long.
+  auto const periods = periods_for(cycle_count);
+  auto const reload = std::max<std::uint64_t>(cycle_count / periods, 2) - 1;
+
+  // Stop the previously scheduled event. Its last period may have ended with
+  // interrupts masked, leaving the interrupt pending, which would otherwise
+  // run against the new event's periods.
   stop();
+  scb->icsr = hal::bit_value<std::uint32_t>(0)
+                .set<interrupt_control_state::pend_systick_clear>()
+                .get();
+
+  m_callback = p_callback;
+  m_periods_remaining = periods;
 
-  // Save the p_callback to the static_callable object's statically allocated
-  // callback function. The lifetime of this object exists for the duration of
-  // the program, so this will never become a dangling reference.
-  auto handler = static_callable<systick_timer, 0, void(void)>(p_callback);
+  // The lifetime of this object exists for the duration of the program, so
+  // this will never become a dangling reference.
+  auto handler = static_callable<systick_timer, 0, void(void)>(
+    [this]() { handle_interrupt(); });
 
   // Enable interrupt service routine for SysTick and use this callback as the
   // handler
-  enable_interrupt(event_number, handler.get_handler());
+  enable_interrupt(irq::systick, handler.get_handler());
+
+  hal::bit_modify(sys_tick->control)
+    .insert<systick_control_register::clock_source>(
+      static_cast<std::uint32_t>(source));
 
   sys_tick->current_value = 0;
-  sys_tick->reload = static_cast<uint32_t>(cycle_count);
+  sys_tick->reload = static_cast<uint32_t>(reload);
 
   // Starting the timer will restart the count
   start();
 }
+
+void systick_timer::handle_interrupt()
+{
+  // The interrupt was already pending when the timer was cancelled
+  if (m_periods_remaining == 0) {
+    return;
+  }
+
+  if (m_periods_remaining > 1) {
+    m_periods_remaining--;
+    return;
+  }
+
+  m_periods_remaining = 0;
+  stop();
+  m_callback();
+}
 }  // namespace hal::cortex_m
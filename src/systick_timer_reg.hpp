@@ -58,7 +58,8 @@ static constexpr auto count_flag = hal::bit_mask::from<16>();
 
 /// The address of the sys_tick register
 inline constexpr std::intptr_t systick_address = 0xE000'E010UL;
-/// The IRQ number for the SysTick interrupt vector
+/// The exception number of the SysTick interrupt vector. Use `irq::systick`
+/// with the interrupt APIs, which are indexed by IRQ number.
 inline constexpr std::uint16_t event_number = 15;
 
 /// @return auto* - Address of the ARM Cortex SysTick peripheral
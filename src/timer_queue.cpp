@@ -0,0 +1,237 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/timer_queue.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal/error.hpp>
+
+namespace hal::cortex_m {
+namespace {
+/// Delays are clamped to this many nanoseconds, over 146 years, so that the
+/// conversion to ticks, and back again, cannot overflow.
+constexpr std::int64_t maximum_delay = std::int64_t{ 1 } << 62;
+
+std::uint64_t ticks_from(frequency_scale const& p_nanoseconds_to_ticks,
+                         hal::time_duration p_delay)
+{
+  if (p_delay.count() <= 0) {
+    return 0;
+  }
+  auto const delay = std::min(p_delay.count(), maximum_delay);
+  return p_nanoseconds_to_ticks.scale(static_cast<std::uint64_t>(delay));
+}
+
+hal::time_duration duration_from(frequency_scale const& p_ticks_to_nanoseconds,
+                                 std::uint64_t p_ticks)
+{
+  constexpr auto limit =
+    static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+  auto const nanoseconds =
+    std::min(p_ticks_to_nanoseconds.scale(p_ticks), limit);
+  return hal::time_duration(static_cast<std::int64_t>(nanoseconds));
+}
+}  // namespace
+
+timer_queue::timer_queue(hal::timer& p_timer,
+                         hal::steady_clock& p_clock,
+                         std::span<timer_event*> p_storage,
+                         hal::time_duration p_maximum_delay)
+  : m_timer(&p_timer)
+  , m_clock(&p_clock)
+  , m_heap(p_storage)
+  , m_nanoseconds_to_ticks(
+      frequency_scale::nanoseconds_to_cycles(p_clock.frequency()))
+  , m_ticks_to_nanoseconds(
+      frequency_scale::cycles_to_nanoseconds(p_clock.frequency()))
+  , m_maximum_ticks(ticks_from(m_nanoseconds_to_ticks, p_maximum_delay))
+{
+  m_timer->cancel();
+}
+
+timer_queue::~timer_queue()
+{
+  critical_section lock;
+  m_timer->cancel();
+  for (auto* event : m_heap.first(m_size)) {
+    event->m_index = timer_event::not_scheduled;
+  }
+  m_size = 0;
+}
+
+void timer_queue::schedule(timer_event& p_event, hal::time_duration p_delay)
+{
+  auto const delay_ticks = ticks_from(m_nanoseconds_to_ticks, p_delay);
+
+  critical_section lock;
+
+  if (p_event.scheduled()) {
+    remove(p_event.m_index);
+  } else if (m_size == m_heap.size()) {
+    hal::safe_throw(hal::resource_unavailable_try_again(this));
+  }
+
+  p_event.m_deadline = m_clock->uptime() + delay_ticks;
+  insert(p_event);
+
+  // Only a new nearest deadline requires the timer to be reprogrammed
+  if (m_heap[0] == &p_event) {
+    program_timer();
+  }
+}
+
+void timer_queue::cancel(timer_event& p_event)
+{
+  critical_section lock;
+
+  if (not p_event.scheduled()) {
+    return;
+  }
+
+  bool const was_nearest = (p_event.m_index == 0);
+  remove(p_event.m_index);
+
+  if (was_nearest) {
+    program_timer();
+  }
+}
+
+hal::time_duration timer_queue::time_until_next()
+{
+  std::uint64_t remaining = 0;
+  {
+    critical_section lock;
+    if (m_size == 0) {
+      return hal::time_duration::max();
+    }
+    auto const now = m_clock->uptime();
+    auto const deadline = m_heap[0]->m_deadline;
+    remaining = deadline > now ? deadline - now : 0U;
+  }
+  return duration_from(m_ticks_to_nanoseconds, remaining);
+}
+
+void timer_queue::dispatch()
+{
+  while (true) {
+    timer_event* expired = nullptr;
+    {
+      critical_section lock;
+      if (m_size != 0 && m_heap[0]->m_deadline <= m_clock->uptime()) {
+        expired = m_heap[0];
+        remove(0);
+      }
+    }
+
+    if (expired == nullptr) {
+      break;
+    }
+
+    // Called outside of the critical section so the callback may schedule
+    // events, including rescheduling itself.
+    expired->m_callback();
+  }
+
+  critical_section lock;
+  program_timer();
+}
+
+void timer_queue::program_timer()
+{
+  if (m_size == 0) {
+    m_timer->cancel();
+    return;
+  }
+
+  auto const now = m_clock->uptime();
+  auto const deadline = m_heap[0]->m_deadline;
+  auto remaining = deadline > now ? deadline - now : 0U;
+  remaining = std::min(remaining, m_maximum_ticks);
+
+  m_timer->schedule([this]() { dispatch(); },
+                    duration_from(m_ticks_to_nanoseconds, remaining));
+}
+
+void timer_queue::insert(timer_event& p_event)
+{
+  place(p_event, m_size++);
+  sift_up(p_event.m_index);
+}
+
+void timer_queue::remove(std::size_t p_index)
+{
+  auto* removed = m_heap[p_index];
+  removed->m_index = timer_event::not_scheduled;
+  m_size--;
+
+  if (p_index == m_size) {
+    return;
+  }
+
+  // Fill the hole with the last event and restore the heap in whichever
+  // direction it was broken.
+  place(*m_heap[m_size], p_index);
+  sift_up(p_index);
+  sift_down(m_heap[p_index]->m_index);
+}
+
+void timer_queue::place(timer_event& p_event, std::size_t p_index)
+{
+  m_heap[p_index] = &p_event;
+  p_event.m_index = p_index;
+}
+
+void timer_queue::sift_up(std::size_t p_index)
+{
+  auto* event = m_heap[p_index];
+  while (p_index > 0) {
+    auto const parent = (p_index - 1) / 2;
+    if (m_heap[parent]->m_deadline <= event->m_deadline) {
+      break;
+    }
+    place(*m_heap[parent], p_index);
+    p_index = parent;
+  }
+  place(*event, p_index);
+}
+
+void timer_queue::sift_down(std::size_t p_index)
+{
+  auto* event = m_heap[p_index];
+  while (true) {
+    auto const left = (2 * p_index) + 1;
+    if (left >= m_size) {
+      break;
+    }
+    auto const right = left + 1;
+    auto child = left;
+    if (right < m_size &&
+        m_heap[right]->m_deadline < m_heap[left]->m_deadline) {
+      child = right;
+    }
+    if (event->m_deadline <= m_heap[child]->m_deadline) {
+      break;
+    }
+    place(*m_heap[child], p_index);
+    p_index = child;
+  }
+  place(*event, p_index);
+}
+}  // namespace hal::cortex_m
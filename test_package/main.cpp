@@ -17,6 +17,7 @@
 #include <span>
 
 #include <libhal-armcortex/dwt_counter.hpp>
+#include <libhal-armcortex/exceptions.hpp>
 
 // Demonstrate function that throws
 void foo()
@@ -34,6 +35,8 @@ int main()
   std::uint64_t uptime = 0;
 
   if (run) {
+    hal::cortex_m::initialize_exception_index();
+
     try {
       hal::cortex_m::dwt_counter counter(1'000'000.0f);
       uptime = counter.uptime();
@@ -0,0 +1,163 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/context_switch.hpp>
+
+#include <array>
+#include <cstdint>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/enum.hpp>
+
+#include "helper.hpp"
+#include "system_controller_reg.hpp"
+
+#include <boost/ut.hpp>
+
+// Called by the PendSV handler, declared here to exercise it directly
+extern "C" std::uint32_t* hal_cortex_m_switch_context(
+  std::uint32_t* p_stack_pointer);
+
+namespace hal::cortex_m {
+namespace {
+void task_entry(void*)
+{
+}
+}  // namespace
+
+void context_switch_test()
+{
+  using namespace boost::ut;
+
+  auto saved_registers = setup_interrupts_for_unit_testing();
+  initialize_interrupts<1>();
+
+  "initialize_task()"_test = []() {
+    // Setup
+    task_context task;
+    alignas(8) std::array<std::uint32_t, 32> stack{};
+    int argument = 0;
+
+    // Exercise
+    initialize_task(task, stack, task_entry, &argument);
+
+    // Verify
+    expect(that % (stack.data() + 32 - 17) == task.stack_pointer);
+    // Room for r4-r11, EXC_RETURN & s16-s31, rounded up to 8 bytes
+    expect(that % (stack.data() + 26) == task.stack_limit);
+    // r4-r11
+    for (std::size_t i = 15; i < 23; i++) {
+      expect(that % 0 == stack[i]);
+    }
+    // EXC_RETURN
+    expect(that % 0xFFFF'FFFD == stack[23]);
+    // r0
+    expect(that % static_cast<std::uint32_t>(
+                    reinterpret_cast<std::uintptr_t>(&argument)) ==
+           stack[24]);
+    // pc
+    expect(that % (static_cast<std::uint32_t>(
+                     reinterpret_cast<std::uintptr_t>(&task_entry)) &
+                   ~1U) ==
+           stack[30]);
+    // xpsr
+    expect(that % (1U << 24) == stack[31]);
+  };
+
+  "initialize_task() with unaligned stack"_test = []() {
+    // Setup
+    task_context task;
+    alignas(8) std::array<std::uint32_t, 32> stack{};
+
+    // Exercise
+    initialize_task(task, std::span(stack).first(31), task_entry, nullptr);
+
+    // Verify: the top of the frame is 8 byte aligned
+    expect(that % (stack.data() + 30 - 17) == task.stack_pointer);
+  };
+
+  "initialize_task() with small stack"_test = []() {
+    // Setup
+    task_context task;
+    alignas(8) std::array<std::uint32_t, 16> stack{};
+
+    // Exercise & Verify
+    expect(throws([&] { initialize_task(task, stack, task_entry, nullptr); }));
+  };
+
+  "context switching"_test = []() {
+    // Setup
+    std::array<task_context, 2> tasks{};
+    std::array<std::uint32_t, 2> fake_stack{};
+    tasks[0].stack_pointer = &fake_stack[0];
+    tasks[1].stack_pointer = &fake_stack[1];
+    std::array<task_context*, 3> previous{};
+    std::size_t switches = 0;
+
+    // Exercise
+    initialize_context_switching([&](task_context* p_current) -> auto& {
+      previous[switches++] = p_current;
+      return p_current == &tasks[0] ? tasks[1] : tasks[0];
+    });
+
+    // Verify
+    expect(that % 0xFF == get_priority(irq::pend_sv));
+    expect(get_vector_table()[hal::value(irq::pend_sv)] !=
+           &default_interrupt_handler);
+    expect(current_task() == nullptr);
+
+    // Exercise: first switch, the bootstrap context is discarded
+    auto* stack_pointer = hal_cortex_m_switch_context(nullptr);
+
+    // Verify
+    expect(that % &fake_stack[0] == stack_pointer);
+    expect(previous[0] == nullptr);
+    expect(current_task() == &tasks[0]);
+
+    // Exercise
+    stack_pointer = hal_cortex_m_switch_context(&fake_stack[1]);
+
+    // Verify: the outgoing stack pointer is saved
+    expect(that % &fake_stack[1] == tasks[0].stack_pointer);
+    expect(that % &fake_stack[1] == stack_pointer);
+    expect(previous[1] == &tasks[0]);
+    expect(current_task() == &tasks[1]);
+
+    // Exercise
+    stack_pointer = hal_cortex_m_switch_context(&fake_stack[0]);
+
+    // Verify
+    expect(that % &fake_stack[0] == tasks[1].stack_pointer);
+    expect(that % &fake_stack[1] == stack_pointer);
+    expect(previous[2] == &tasks[1]);
+    expect(current_task() == &tasks[0]);
+  };
+
+  "bootstrap_stack_words"_test = []() {
+    // Verify: an extended frame with padding, r4-r11, EXC_RETURN & s16-s31
+    expect(that % 52 == bootstrap_stack_words);
+  };
+
+  "request_context_switch()"_test = []() {
+    // Setup
+    scb->icsr = 0;
+
+    // Exercise
+    request_context_switch();
+
+    // Verify
+    expect(that % (1U << 28) == scb->icsr);
+  };
+}
+}  // namespace hal::cortex_m
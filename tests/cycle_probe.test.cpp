@@ -0,0 +1,85 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/cycle_probe.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+namespace {
+std::uint32_t volatile fake_cycle_count = 0;
+
+void measure(std::uint32_t p_start, std::uint32_t p_cycles)
+{
+  fake_cycle_count = p_start;
+  cycle_probe<"measure"> probe;
+  fake_cycle_count = p_start + p_cycles;
+}
+}  // namespace
+
+void cycle_probe_test()
+{
+  using namespace boost::ut;
+
+  auto* original_register = cycle_count_register;
+  cycle_count_register = &fake_cycle_count;
+
+  "cycle_probe"_test = []() {
+    // Exercise
+    measure(100, 5);
+    measure(0xFFFF'FFF0, 0x20);  // CYCCNT wraps
+    measure(0, 0);
+    {
+      fake_cycle_count = 10;
+      cycle_probe<"other"> probe;
+      fake_cycle_count = 1034;
+    }
+
+    // Verify
+    auto const records = cycle_records();
+    expect(that % 2 == records.size());
+
+    auto const& measure_record = records[0];
+    expect(std::string_view("measure") == measure_record.name);
+    expect(that % 3 == measure_record.count);
+    expect(that % 0 == measure_record.min);
+    expect(that % 0x20 == measure_record.max);
+    expect(that % 37 == measure_record.sum);
+    expect(that % 1 == measure_record.histogram[0]);
+    expect(that % 1 == measure_record.histogram[3]);
+    expect(that % 1 == measure_record.histogram[6]);
+    expect(&measure_record == &cycle_probe<"measure">::record());
+
+    auto const& other_record = records[1];
+    expect(std::string_view("other") == other_record.name);
+    expect(that % 1 == other_record.count);
+    expect(that % 1024 == other_record.max);
+    expect(that % 1 == other_record.histogram[11]);
+
+    // Exercise
+    reset_cycle_records();
+
+    // Verify
+    expect(that % 2 == cycle_records().size());
+    expect(that % 0 == cycle_records()[0].count);
+    expect(that % 0 == cycle_records()[0].histogram[3]);
+    expect(std::string_view("measure") == cycle_records()[0].name);
+  };
+
+  cycle_count_register = original_register;
+}
+}  // namespace hal::cortex_m
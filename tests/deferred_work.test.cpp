@@ -0,0 +1,142 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/deferred_work.hpp>
+
+#include <array>
+#include <vector>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/enum.hpp>
+
+#include "helper.hpp"
+#include "system_controller_reg.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void deferred_work_test()
+{
+  using namespace boost::ut;
+
+  auto saved_registers = setup_interrupts_for_unit_testing();
+  initialize_interrupts<1>();
+
+  constexpr std::uint32_t pend_sv_set = 1 << 28;
+  auto const pend_sv = [] { get_vector_table()[hal::value(irq::pend_sv)](); };
+
+  std::vector<int> calls;
+  auto const record = [](void* p_context) {
+    auto& context = *static_cast<std::pair<std::vector<int>*, int>*>(p_context);
+    context.first->push_back(context.second);
+  };
+  std::pair<std::vector<int>*, int> first{ &calls, 1 };
+  std::pair<std::vector<int>*, int> second{ &calls, 2 };
+  std::pair<std::vector<int>*, int> third{ &calls, 3 };
+
+  "defer() before initialization"_test = [&]() {
+    // Exercise & Verify
+    expect(not defer(record, &first));
+    expect(that % 0 == scb->icsr);
+  };
+
+  "initialize_deferred_work() with invalid storage"_test = []() {
+    // Setup
+    std::array<deferred_work_slot, 3> storage{};
+
+    // Exercise & Verify
+    expect(throws([&storage] { initialize_deferred_work(storage); }));
+    expect(throws([] { initialize_deferred_work({}); }));
+  };
+
+  "defer()"_test = [&]() {
+    // Setup
+    std::array<deferred_work_slot, 2> storage{};
+    initialize_deferred_work(storage);
+    calls.clear();
+
+    // Verify
+    expect(that % 0xFF == get_priority(irq::pend_sv));
+    expect(that % 0 == deferred_work_dropped());
+
+    // Exercise
+    expect(defer(record, &first));
+    expect(defer(record, &second));
+
+    // Verify
+    expect(that % pend_sv_set == scb->icsr);
+    expect(calls.empty());
+
+    // Exercise: the queue is full
+    expect(not defer(record, &third));
+
+    // Verify
+    expect(that % 1 == deferred_work_dropped());
+
+    // Exercise
+    scb->icsr = 0;
+    pend_sv();
+
+    // Verify: calls are made in order and the queue has been drained
+    expect(that % std::vector<int>{ 1, 2 } == calls);
+    expect(that % 0 == scb->icsr);
+
+    // Exercise: the queue can be used again after it wraps
+    expect(defer(record, &third));
+    expect(defer(record, &first));
+    pend_sv();
+    pend_sv();
+
+    // Verify
+    expect(that % std::vector<int>{ 1, 2, 3, 1 } == calls);
+  };
+
+  "defer() from deferred work"_test = [&]() {
+    // Setup
+    initialize_deferred_work<4>();
+    int count = 0;
+    hal::callback<void(void)> callback = [&count, &callback]() {
+      count++;
+      if (count < 8) {
+        expect(defer(callback));
+      }
+    };
+
+    // Exercise
+    expect(defer(callback));
+    scb->icsr = 0;
+    pend_sv();
+
+    // Verify: each run is limited to one pass over the queue, then re-pends
+    expect(that % 4 == count);
+    expect(that % pend_sv_set == scb->icsr);
+
+    // Exercise
+    scb->icsr = 0;
+    pend_sv();
+
+    // Verify
+    expect(that % 8 == count);
+    expect(that % pend_sv_set == scb->icsr);
+
+    // Exercise: the final run finds the queue empty
+    scb->icsr = 0;
+    pend_sv();
+
+    // Verify
+    expect(that % 8 == count);
+    expect(that % 0 == scb->icsr);
+  };
+}
+}  // namespace hal::cortex_m
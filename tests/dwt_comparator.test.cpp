@@ -0,0 +1,129 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/dwt_comparator.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "dwt_counter_reg.hpp"
+#include "helper.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void dwt_comparator_test()
+{
+  using namespace boost::ut;
+
+  auto stub_out_core = stub_out_registers(&core);
+  auto stub_out_dwt = stub_out_registers(&dwt);
+
+  // 4 comparators
+  dwt->ctrl = 4 << 28;
+
+  "dwt_comparator_count()"_test = []() {
+    expect(that % 4 == dwt_comparator_count());
+  };
+
+  "dwt_watchpoint::ctor()"_test = []() {
+    // Setup
+    alignas(8) std::array<std::uint32_t, 4> buffer{};
+
+    // Exercise
+    {
+      dwt_watchpoint test_subject(&buffer[2], 8, dwt_access::write);
+
+      // Verify
+      expect(that % 3 == test_subject.comparator());
+      auto const address = reinterpret_cast<std::uintptr_t>(&buffer[2]);
+      expect(that % static_cast<std::uint32_t>(address) == dwt->comp3);
+      expect(that % 3 == dwt->mask3);
+      expect(that % 0b0110 == dwt->function3);
+      expect(that % (core_trace_enable | debug_monitor_enable) ==
+             core->demcr);
+
+      // Exercise
+      dwt->function3 = dwt->function3 | (1 << 24);
+
+      // Verify
+      expect(test_subject.triggered());
+    }
+
+    // Verify
+    expect(that % 0 == dwt->function3);
+  };
+
+  "dwt_watchpoint::ctor() with invalid range"_test = []() {
+    // Setup
+    alignas(8) std::array<std::uint32_t, 4> buffer{};
+
+    // Exercise & Verify
+    expect(throws([&buffer] {
+      dwt_watchpoint test_subject(&buffer[1], 8, dwt_access::read);
+    }));
+    expect(throws([&buffer] {
+      dwt_watchpoint test_subject(&buffer[0], 12, dwt_access::read);
+    }));
+  };
+
+  "dwt comparator allocation"_test = []() {
+    // Setup
+    std::uint32_t word = 0;
+
+    // Exercise
+    dwt_watchpoint watchpoint3(&word, 4, dwt_access::read_write);
+    dwt_watchpoint watchpoint2(&word, 4, dwt_access::read_write);
+    dwt_watchpoint watchpoint1(&word, 4, dwt_access::read_write);
+
+    {
+      dwt_cycle_match cycle_match(1'000);
+
+      // Verify
+      expect(that % 1'000 == dwt->comp0);
+      expect(that % 0b1000'0100 == dwt->function0);
+      expect(that % enable_cycle_count == (dwt->ctrl & enable_cycle_count));
+      expect(throws([&word] {
+        dwt_watchpoint test_subject(&word, 4, dwt_access::read_write);
+      }));
+
+      // Exercise
+      cycle_match.rearm(2'000);
+
+      // Verify
+      expect(that % 2'000 == dwt->comp0);
+      expect(not cycle_match.triggered());
+    }
+
+    // Exercise
+    std::optional<dwt_watchpoint> watchpoint0;
+    watchpoint0.emplace(&word, 4, dwt_access::read_write);
+
+    // Verify
+    expect(that % 3 == watchpoint3.comparator());
+    expect(that % 2 == watchpoint2.comparator());
+    expect(that % 1 == watchpoint1.comparator());
+    expect(that % 0 == watchpoint0->comparator());
+    expect(throws([] { dwt_cycle_match test_subject(0); }));
+
+    // Exercise
+    watchpoint0.reset();
+    dwt_cycle_match cycle_match(0);
+
+    // Verify
+    expect(that % 0b1000'0100 == dwt->function0);
+  };
+}
+}  // namespace hal::cortex_m
@@ -25,6 +25,7 @@ void dwt_test()
 {
   using namespace boost::ut;
   using namespace hal::cortex_m;
+  using namespace std::chrono_literals;
 
   auto stub_out_core = stub_out_registers(&core);
   auto stub_out_dwt = stub_out_registers(&dwt);
@@ -49,20 +50,30 @@ void dwt_test()
       expect(that % 17 == count);
     }
     {
-      dwt->cyccnt = 1024;
+      dwt->cyccnt = 0xF000'0000;
       auto count = test_subject.uptime();
-      expect(that % 1024 == count);
+      expect(that % 0xF000'0000 == count);
     }
     {
       dwt->cyccnt = 5;
       auto count = test_subject.uptime();
       expect(that % (1ULL << 32 | 5) == count);
     }
+    {
+      dwt->cyccnt = 0x8000'0000;
+      auto count = test_subject.uptime();
+      expect(that % (1ULL << 32 | 0x8000'0000) == count);
+    }
     {
       dwt->cyccnt = 4;
       auto count = test_subject.uptime();
       expect(that % (2ULL << 32 | 4) == count);
     }
+    {
+      dwt->cyccnt = 0x1000'0000;
+      auto count = test_subject.uptime();
+      expect(that % (2ULL << 32 | 0x1000'0000) == count);
+    }
     {
       dwt->cyccnt = 3;
       auto count = test_subject.uptime();
@@ -75,6 +86,21 @@ void dwt_test()
     }
   };
 
+  "dwt_counter::now()"_test = []() {
+    // Setup
+    dwt_counter test_subject(operating_frequency);
+
+    // Exercise & Verify
+    dwt->cyccnt = 0x0FFF'FFFF;
+    expect(that % 0x0FFF'FFFF == test_subject.now());
+    dwt->cyccnt = 0xFFFF'FFFF;
+    expect(that % 0xFFFF'FFFF == test_subject.now());
+    expect(that % 0xFFFF'FFFF == test_subject.uptime());
+    dwt->cyccnt = 0;
+    expect(that % (1ULL << 32) == test_subject.now());
+    expect(that % (1ULL << 32) == test_subject.uptime());
+  };
+
   "dwt_counter::register_cpu_frequency()"_test = []() {
     dwt_counter test_subject(operating_frequency);
     {
@@ -105,5 +131,23 @@ void dwt_test()
       expect(that % 0.01f > std::abs(freq - expected_frequency));
     }
   };
+
+  "dwt_counter::uptime_ns() & duration_to_cycles()"_test = []() {
+    // Setup
+    dwt_counter test_subject(48.0_MHz);
+
+    // Exercise & Verify
+    dwt->cyccnt = 48'000;
+    expect(that % 1'000'000 == test_subject.uptime_ns());
+    expect(that % 48'000 == test_subject.duration_to_cycles(1ms));
+    expect(that % 0 == test_subject.duration_to_cycles(-1ms));
+
+    // Exercise
+    test_subject.register_cpu_frequency(1.0_MHz);
+
+    // Verify
+    expect(that % 48'000'000 == test_subject.uptime_ns());
+    expect(that % 1'000 == test_subject.duration_to_cycles(1ms));
+  };
 };
 }  // namespace hal::cortex_m
@@ -0,0 +1,111 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/dwt_profiler.hpp>
+
+#include "dwt_counter_reg.hpp"
+#include "helper.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void dwt_profiler_test()
+{
+  using namespace boost::ut;
+
+  auto stub_out_core = stub_out_registers(&core);
+  auto stub_out_dwt = stub_out_registers(&dwt);
+
+  "dwt_profiler::ctor()"_test = []() {
+    // Setup
+    dwt->cpicnt = 0xAA;
+    dwt->foldcnt = 0xAA;
+
+    // Exercise
+    {
+      dwt_profiler test_subject;
+
+      // Verify
+      expect(that % core_trace_enable == core->demcr);
+      expect(that % 0x003E'0001 == dwt->ctrl);
+      expect(that % 0 == dwt->cpicnt);
+      expect(that % 0 == dwt->foldcnt);
+    }
+
+    // Verify: cycle counter is left running
+    expect(that % 0x0000'0001 == dwt->ctrl);
+  };
+
+  "dwt_profiler::ctor(settings)"_test = []() {
+    // Setup
+    dwt->ctrl = 0;
+
+    // Exercise
+    dwt_profiler test_subject({
+      .cpi = false,
+      .exception = true,
+      .sleep = false,
+      .lsu = true,
+      .fold = false,
+    });
+
+    // Verify
+    expect(that % 0x0014'0001 == dwt->ctrl);
+  };
+
+  "dwt_profiler::ctor() without profiling counters"_test = []() {
+    // Setup
+    dwt->ctrl = 1 << 24;
+
+    // Exercise & Verify
+    expect(throws([] { dwt_profiler test_subject; }));
+    dwt->ctrl = 0;
+  };
+
+  "dwt_profiler::snapshot()"_test = []() {
+    // Setup
+    dwt->cyccnt = 1000;
+    dwt_profiler test_subject({ .cpi = true,
+                                .exception = true,
+                                .sleep = true,
+                                .lsu = true,
+                                .fold = false });
+    auto const start = test_subject.snapshot();
+
+    // Exercise
+    dwt->cyccnt = 5000;
+    dwt->cpicnt = 200;
+    dwt->exccnt = 10;
+    dwt->sleepcnt = 250;
+    dwt->lsucnt = 30;
+    dwt->foldcnt = 40;
+    test_subject.sample();
+    dwt->cpicnt = 100;  // wrapped
+    dwt->sleepcnt = 4;  // wrapped
+    auto const end = test_subject.snapshot();
+    auto const delta = end - start;
+
+    // Verify
+    expect(that % 1000 == start.cycles);
+    expect(that % 0 == start.cpi);
+    expect(that % 4000 == delta.cycles);
+    expect(that % (256 + 100) == delta.cpi);
+    expect(that % 10 == delta.exception);
+    expect(that % (256 + 4) == delta.sleep);
+    expect(that % 30 == delta.lsu);
+    // Not enabled
+    expect(that % 0 == delta.fold);
+  };
+}
+}  // namespace hal::cortex_m
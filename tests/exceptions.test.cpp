@@ -0,0 +1,187 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/exceptions.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+namespace {
+/// Point an entry at a function address with a prel31 offset
+void encode(exception_index_entry& p_entry, std::uintptr_t p_function)
+{
+  auto const place = reinterpret_cast<std::uintptr_t>(&p_entry.function_offset);
+  p_entry.function_offset =
+    static_cast<std::uint32_t>(p_function - place) & 0x7FFF'FFFF;
+  p_entry.content = 1;
+}
+
+/// Index of the last entry, within the span, starting at or before p_address
+std::ptrdiff_t covering_entry(std::span<exception_index_entry const> p_table,
+                              std::span<std::uintptr_t const> p_functions,
+                              std::uintptr_t p_address)
+{
+  std::ptrdiff_t covering = -1;
+  for (std::size_t i = 0; i < p_table.size(); i++) {
+    if (p_functions[i] <= p_address) {
+      covering = static_cast<std::ptrdiff_t>(i);
+    }
+  }
+  return covering;
+}
+}  // namespace
+
+void exceptions_test()
+{
+  using namespace boost::ut;
+
+  "exception pool before initialization"_test = []() {
+    // Exercise & Verify
+    expect(that % default_exception_pool_size == exception_pool_available());
+
+    // Exercise
+    auto* const first = allocate_exception(16);
+    auto* const second = allocate_exception(max_exception_object_size);
+
+    // Verify
+    expect(first != nullptr);
+    expect(second != nullptr);
+    expect(first != second);
+    expect(that % 0 == exception_pool_available());
+    expect(allocate_exception(16) == nullptr);
+
+    // Exercise
+    free_exception(first);
+    free_exception(second);
+
+    // Verify
+    expect(that % default_exception_pool_size == exception_pool_available());
+  };
+
+  "initialize_exception_pool()"_test = []() {
+    // Exercise & Verify
+    expect(throws([] { initialize_exception_pool({}); }));
+
+    // Exercise
+    initialize_exception_pool<3>();
+
+    // Verify
+    expect(that % 3 == exception_pool_available());
+  };
+
+  "allocate_exception()"_test = []() {
+    // Setup
+    auto* object = static_cast<hal::byte*>(allocate_exception(32));
+    expect(object != nullptr);
+    std::fill_n(object - exception_header_size, exception_header_size, 0xAA);
+    free_exception(object);
+
+    // Exercise
+    object = static_cast<hal::byte*>(allocate_exception(32));
+
+    // Verify: aligned for any type and the runtime's header is zeroed
+    auto const address = reinterpret_cast<std::uintptr_t>(object);
+    expect(that % 0 == address % alignof(std::max_align_t));
+    expect(std::all_of(object - exception_header_size, object, [](auto p) {
+      return p == 0;
+    }));
+    expect(that % 2 == exception_pool_available());
+
+    // Exercise & Verify: too large for the pool
+    expect(allocate_exception(max_exception_object_size + 1) == nullptr);
+    expect(that % 2 == exception_pool_available());
+
+    // Exercise: memory outside of the pool is ignored
+    int outside = 0;
+    free_exception(&outside);
+    free_exception(nullptr);
+
+    // Verify
+    expect(that % 2 == exception_pool_available());
+
+    // Exercise
+    free_exception(object);
+
+    // Verify
+    expect(that % 3 == exception_pool_available());
+  };
+
+  "allocate_dependent_exception()"_test = []() {
+    // Exercise
+    auto* const dependent =
+      static_cast<hal::byte*>(allocate_dependent_exception());
+
+    // Verify
+    expect(dependent != nullptr);
+    expect(std::all_of(dependent,
+                       dependent + exception_header_size,
+                       [](auto p) { return p == 0; }));
+    expect(that % 2 == exception_pool_available());
+
+    // Exercise
+    free_exception(dependent);
+
+    // Verify
+    expect(that % 3 == exception_pool_available());
+  };
+
+  "initialize_exception_index()"_test = []() {
+    // Setup
+    std::array<exception_index_entry, 8> table{};
+    auto const start = reinterpret_cast<std::uintptr_t>(&table) + 0x1'0000;
+    std::array<std::uintptr_t, 8> const functions{
+      start,         start + 0x10,  start + 0x20,  start + 0x100,
+      start + 0x110, start + 0x400, start + 0x800, start + 0x1000,
+    };
+    for (std::size_t i = 0; i < table.size(); i++) {
+      encode(table[i], functions[i]);
+    }
+    std::array<std::uint32_t, 4> buckets{};
+    std::array<std::uint32_t, 1> too_few_buckets{};
+
+    // Exercise & Verify
+    expect(throws(
+      [&] { initialize_exception_index(table, too_few_buckets); }));
+
+    // Exercise
+    initialize_exception_index(table, buckets);
+
+    // Verify: an address before the first function is not covered
+    auto const before = find_exception_index(start - 1);
+    expect(that % 1 == before.size());
+    expect(that % table.data() == before.data());
+
+    // Verify: each range holds the entry covering the address
+    bool always_covered = true;
+    std::size_t largest_range = 0;
+    for (auto address = start; address < start + 0x1100; address += 4) {
+      auto const range = find_exception_index(address);
+      auto const offset = range.data() - table.data();
+      auto const expected = covering_entry(table, functions, address);
+      auto const found =
+        offset + covering_entry(range, std::span(functions).subspan(offset),
+                                address);
+      always_covered = always_covered && (expected == found);
+      largest_range = std::max(largest_range, range.size());
+    }
+    expect(always_covered);
+    expect(that % largest_range < table.size());
+  };
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,161 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <libhal-armcortex/fault.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/enum.hpp>
+
+#include "helper.hpp"
+#include "system_controller_reg.hpp"
+
+#include <boost/ut.hpp>
+
+// Called by the fault handler, declared here to exercise it directly
+extern "C" void hal_cortex_m_record_fault(std::uint32_t const* p_frame,
+                                          std::uint32_t p_exc_return);
+
+namespace hal::cortex_m {
+namespace {
+/// Return to thread mode on the main stack with a basic frame
+constexpr std::uint32_t exc_return_thread_msp = 0xFFFF'FFF9;
+}  // namespace
+
+void fault_test()
+{
+  using namespace boost::ut;
+
+  auto saved_registers = setup_interrupts_for_unit_testing();
+  initialize_interrupts<1>();
+
+  "take_fault_record() without a fault"_test = []() {
+    // Setup
+    fault_record record{};
+
+    // Exercise & Verify
+    expect(not take_fault_record(record));
+  };
+
+  "install_fault_capture()"_test = []() {
+    // Exercise
+    install_fault_capture();
+
+    // Verify
+    expect(verify_vector_enabled(irq::hard_fault, fault_capture_handler));
+    expect(verify_vector_enabled(irq::memory_management_fault,
+                                 fault_capture_handler));
+    expect(verify_vector_enabled(irq::bus_fault, fault_capture_handler));
+    expect(verify_vector_enabled(irq::usage_fault, fault_capture_handler));
+  };
+
+  "hal_cortex_m_record_fault() & take_fault_record()"_test = []() {
+    // Setup: frame of a precise BusFault escalated to HardFault
+    std::array<std::uint32_t, 80> stack{};
+    std::array<std::uint32_t, 8> const frame{
+      1, 2, 3, 4, 12, 0x0800'0401, 0x0800'0300, 1 << 24
+    };
+    std::ranges::copy(frame, stack.begin());
+    // Not return addresses: data and an even address
+    stack[8] = 0x1234'5670;
+    // Return addresses of the callers of the faulting function
+    stack[9] = 0x0800'0501;
+    stack[11] = 0x0800'0601;
+    scb->icsr = 3;
+    scb->cfsr = (1 << 15) | (1 << 9);
+    scb->hfsr = 1 << 30;
+    scb->mmfar = 0;
+    scb->bfar = 0x2000'1000;
+    fault_record record{};
+
+    // Exercise
+    hal_cortex_m_record_fault(stack.data(), exc_return_thread_msp);
+
+    // Verify
+    expect(take_fault_record(record));
+    expect(that % 1 == record.frame.r0);
+    expect(that % 4 == record.frame.r3);
+    expect(that % 12 == record.frame.r12);
+    expect(that % 0x0800'0401 == record.frame.lr);
+    expect(that % 0x0800'0300 == record.frame.pc);
+    expect(that % (1 << 24) == record.frame.xpsr);
+    expect(that % exc_return_thread_msp == record.exc_return);
+    expect(that % 3 == record.exception_number);
+    expect(that % ((1 << 15) | (1 << 9)) == record.cfsr);
+    expect(that % (1 << 30) == record.hfsr);
+    expect(that % 0x2000'1000 == record.bfar);
+    expect(that % 4 == record.backtrace_depth);
+    expect(that % 0x0800'0300 == record.backtrace[0]);
+    expect(that % 0x0800'0401 == record.backtrace[1]);
+    expect(that % 0x0800'0501 == record.backtrace[2]);
+    expect(that % 0x0800'0601 == record.backtrace[3]);
+
+    // Exercise & Verify: the record is only reported once
+    expect(not take_fault_record(record));
+  };
+
+  "hal_cortex_m_record_fault() with an aligned & extended frame"_test = []() {
+    // Setup: the frame holds s0-s15, FPSCR & a word of alignment padding
+    std::array<std::uint32_t, 100> stack{};
+    stack[5] = 0x0800'0401;
+    stack[6] = 0x0800'0300;
+    stack[7] = (1 << 24) | (1 << 9);
+    // Within the floating point state and the padding, thus skipped
+    stack[8] = 0x0800'0701;
+    stack[26] = 0x0800'0701;
+    stack[27] = 0x0800'0801;
+    scb->icsr = 6;
+    scb->cfsr = 1 << 16;
+    fault_record record{};
+
+    // Exercise: floating point state is stacked when bit 4 is clear
+    hal_cortex_m_record_fault(stack.data(), 0xFFFF'FFE9);
+
+    // Verify
+    expect(take_fault_record(record));
+    expect(that % 6 == record.exception_number);
+    expect(that % 3 == record.backtrace_depth);
+    expect(that % 0x0800'0300 == record.backtrace[0]);
+    expect(that % 0x0800'0401 == record.backtrace[1]);
+    expect(that % 0x0800'0801 == record.backtrace[2]);
+  };
+
+  "hal_cortex_m_record_fault() after a stacking error"_test = []() {
+    // Setup
+    std::array<std::uint32_t, 80> stack{};
+    stack.fill(0x0800'0101);
+    scb->icsr = 5;
+    scb->cfsr = 1 << 12;
+    fault_record record{};
+
+    // Exercise
+    hal_cortex_m_record_fault(stack.data(), exc_return_thread_msp);
+
+    // Verify: the frame is untrusted and is not read
+    expect(take_fault_record(record));
+    expect(that % (1 << 12) == record.cfsr);
+    expect(that % 0 == record.frame.pc);
+    expect(that % 0 == record.backtrace_depth);
+  };
+
+  scb->icsr = 0;
+  scb->cfsr = 0;
+  scb->hfsr = 0;
+  scb->bfar = 0;
+}
+}  // namespace hal::cortex_m
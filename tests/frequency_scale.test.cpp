@@ -0,0 +1,97 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/frequency_scale.hpp>
+
+#include <cstdint>
+#include <limits>
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void frequency_scale_test()
+{
+  using namespace boost::ut;
+
+  "frequency_scale::from_ratio()"_test = []() {
+    // Setup
+    constexpr auto one = frequency_scale::from_ratio(1.0);
+    constexpr auto half = frequency_scale::from_ratio(0.5);
+    constexpr auto zero = frequency_scale::from_ratio(0.0);
+    constexpr auto nan =
+      frequency_scale::from_ratio(std::numeric_limits<double>::quiet_NaN());
+    constexpr auto huge = frequency_scale::from_ratio(1e12);
+
+    // Verify
+    static_assert(one.multiplier() == 1U << 31);
+    static_assert(one.shift() == 31);
+    static_assert(half.multiplier() == 1U << 31);
+    static_assert(half.shift() == 32);
+    expect(that % 12345 == one.scale(12345));
+    expect(that % 6172 == half.scale(12345));
+    expect(that % 0 == zero.scale(12345));
+    expect(that % 0 == nan.scale(12345));
+    expect(that % (0xFFFF'FFFFULL * 2) == huge.scale(2));
+  };
+
+  "frequency_scale::scale() with 64-bit values"_test = []() {
+    // Setup
+    constexpr auto one = frequency_scale::from_ratio(1.0);
+    constexpr auto three = frequency_scale::from_ratio(3.0);
+    constexpr std::uint64_t large = (1ULL << 62) + 7;
+
+    // Exercise & Verify
+    expect(that % large == one.scale(large));
+    expect(that % ((1ULL << 40) * 3) == three.scale(1ULL << 40));
+    expect(that % 0 == one.scale(0));
+  };
+
+  "frequency_scale::nanoseconds_to_cycles()"_test = []() {
+    // Setup
+    constexpr auto at_48mhz = frequency_scale::nanoseconds_to_cycles(48e6f);
+    constexpr auto at_1khz = frequency_scale::nanoseconds_to_cycles(1e3f);
+
+    // Exercise & Verify
+    expect(that % 48 == at_48mhz.scale(1'000));
+    expect(that % 48'000 == at_48mhz.scale(1'000'000));
+    expect(that % 48'000'000 == at_48mhz.scale(1'000'000'000));
+
+    // Large values are rounded up by less than 1 part in 2^31
+    constexpr std::uint64_t cycles_in_an_hour = 48'000'000ULL * 3'600;
+    auto const hour = at_48mhz.scale(3'600'000'000'000ULL);
+    expect(that % cycles_in_an_hour <= hour);
+    expect(that % hour <= cycles_in_an_hour + (cycles_in_an_hour >> 31));
+    expect(that % 1 == at_1khz.scale(1'000'000));
+    expect(that % 3'600'000 == at_1khz.scale(3'600'000'000'000ULL));
+  };
+
+  "frequency_scale::cycles_to_nanoseconds()"_test = []() {
+    // Setup
+    constexpr auto at_48mhz = frequency_scale::cycles_to_nanoseconds(48e6f);
+    constexpr auto at_zero = frequency_scale::cycles_to_nanoseconds(0.0f);
+
+    // Exercise & Verify
+    expect(that % 1'000 == at_48mhz.scale(48));
+    expect(that % 1'000'000'000 == at_48mhz.scale(48'000'000));
+
+    // Large values are rounded up by less than 1 part in 2^31
+    constexpr std::uint64_t nanoseconds_in_an_hour = 3'600'000'000'000ULL;
+    auto const hour = at_48mhz.scale(48'000'000ULL * 3'600);
+    expect(that % nanoseconds_in_an_hour <= hour);
+    expect(that % hour <=
+           nanoseconds_in_an_hour + (nanoseconds_in_an_hour >> 31));
+    expect(that % 0 == at_zero.scale(48));
+  };
+}
+}  // namespace hal::cortex_m
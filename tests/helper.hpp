@@ -2,11 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 #include <libhal-armcortex/interrupt.hpp>
 #include <libhal/units.hpp>
 
 #include "interrupt_reg.hpp"
+#include "mmio.hpp"
 #include "system_controller_reg.hpp"
 
 namespace hal::cortex_m {
@@ -58,6 +63,92 @@ private:
   bool m_moved = false;
 };
 
+/**
+ * @brief Records every access to mmio registers while it is alive
+ *
+ * Used to hold the hot paths to a budget of register reads and writes. Only
+ * registers declared with `mmio<T>`, such as those of the NVIC and SCB, are
+ * recorded.
+ */
+class mmio_recorder
+{
+public:
+  mmio_recorder()
+  {
+    mmio_access_log = &m_accesses;
+  }
+
+  mmio_recorder(mmio_recorder const&) = delete;
+  mmio_recorder& operator=(mmio_recorder const&) = delete;
+  mmio_recorder(mmio_recorder&&) = delete;
+  mmio_recorder& operator=(mmio_recorder&&) = delete;
+
+  ~mmio_recorder()
+  {
+    mmio_access_log = nullptr;
+  }
+
+  /**
+   * @brief Get every access in the order it was made
+   *
+   * @return std::span<mmio_access const> - recorded accesses
+   */
+  [[nodiscard]] std::span<mmio_access const> accesses() const
+  {
+    return m_accesses;
+  }
+
+  /**
+   * @brief Count the reads of a register, an array of registers or a whole
+   * register map, such as `*nvic`
+   *
+   * @param p_registers - registers to count the reads of
+   * @return std::size_t - number of reads
+   */
+  template<typename T>
+  [[nodiscard]] std::size_t reads(T const& p_registers) const
+  {
+    return count(p_registers, mmio_operation::read);
+  }
+
+  /**
+   * @brief Count the writes to a register, an array of registers or a whole
+   * register map, such as `*nvic`
+   *
+   * @param p_registers - registers to count the writes to
+   * @return std::size_t - number of writes
+   */
+  template<typename T>
+  [[nodiscard]] std::size_t writes(T const& p_registers) const
+  {
+    return count(p_registers, mmio_operation::write);
+  }
+
+  /**
+   * @brief Forget every access recorded so far
+   *
+   */
+  void clear()
+  {
+    m_accesses.clear();
+  }
+
+private:
+  template<typename T>
+  std::size_t count(T const& p_registers, mmio_operation p_operation) const
+  {
+    auto const start = reinterpret_cast<std::uintptr_t>(&p_registers);
+    auto const end = start + sizeof(T);
+    return std::count_if(
+      m_accesses.begin(), m_accesses.end(), [=](mmio_access const& p_access) {
+        return p_access.operation == p_operation &&
+               start <= p_access.address && p_access.address < end;
+      });
+  }
+
+  std::vector<mmio_access> m_accesses;
+};
+
 inline void fake_top_of_stack()
 {
   while (true) {
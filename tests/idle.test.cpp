@@ -0,0 +1,117 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/idle.hpp>
+
+#include <chrono>
+
+#include "dwt_counter_reg.hpp"
+#include "helper.hpp"
+#include "system_controller_reg.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void idle_test()
+{
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+
+  auto stub_out_scb = stub_out_registers(&scb);
+  auto stub_out_core = stub_out_registers(&core);
+  auto stub_out_dwt = stub_out_registers(&dwt);
+
+  constexpr std::uint32_t sleep_on_exit = 1 << 1;
+  constexpr std::uint32_t sleep_deep = 1 << 2;
+  constexpr std::uint32_t send_event_on_pending = 1 << 4;
+
+  "configure_idle()"_test = [&]() {
+    // Exercise
+    configure_idle({ .sleep_on_exit = true, .send_event_on_pending = true });
+
+    // Verify
+    expect(that % (sleep_on_exit | send_event_on_pending) == scb->scr);
+    expect(that % core_trace_enable == core->demcr);
+    expect(that % enable_cycle_count == dwt->ctrl);
+
+    // Exercise
+    configure_idle({});
+
+    // Verify
+    expect(that % 0 == scb->scr);
+    expect(sleep_depth::sleep == select_sleep_depth(1h));
+    expect(sleep_depth::sleep ==
+           select_sleep_depth(hal::time_duration::max()));
+  };
+
+  "select_sleep_depth()"_test = [&]() {
+    // Setup
+    configure_idle({ .deep_sleep_threshold = 5ms });
+
+    // Exercise & Verify
+    expect(sleep_depth::sleep == select_sleep_depth(1ms));
+    expect(sleep_depth::sleep == select_sleep_depth(5ms));
+    expect(sleep_depth::deep_sleep == select_sleep_depth(6ms));
+    expect(sleep_depth::deep_sleep ==
+           select_sleep_depth(hal::time_duration::max()));
+  };
+
+  "idle()"_test = [&]() {
+    // Setup
+    dwt->cyccnt = 1'000;
+    configure_idle({ .deep_sleep_threshold = 5ms });
+
+    // Exercise
+    dwt->cyccnt = 1'300;
+    auto const depth = idle(10ms);
+
+    // Verify
+    expect(sleep_depth::deep_sleep == depth);
+    expect(that % sleep_deep == scb->scr);
+
+    // Exercise
+    dwt->cyccnt = 1'400;
+    auto const next_depth = idle_until_event(1ms);
+
+    // Verify
+    expect(sleep_depth::sleep == next_depth);
+    expect(that % 0 == scb->scr);
+
+    auto const statistics = get_idle_statistics();
+    expect(that % 1 == statistics.sleeps);
+    expect(that % 1 == statistics.deep_sleeps);
+    expect(that % 400 == statistics.awake_cycles);
+    expect(that % 0 == statistics.asleep_cycles);
+    expect(that % 0.0f == statistics.sleep_ratio());
+
+    // Exercise
+    reset_idle_statistics();
+
+    // Verify
+    expect(that % 0 == get_idle_statistics().sleeps);
+  };
+
+  "idle_statistics::sleep_ratio()"_test = []() {
+    // Setup
+    idle_statistics const statistics{
+      .asleep_cycles = 300,
+      .awake_cycles = 100,
+    };
+
+    // Exercise & Verify
+    expect(that % 0.75f == statistics.sleep_ratio());
+    expect(that % 0.0f == idle_statistics{}.sleep_ratio());
+  };
+}
+}  // namespace hal::cortex_m
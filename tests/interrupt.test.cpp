@@ -14,8 +14,11 @@
 
 #include <libhal-armcortex/interrupt.hpp>
 
+#include <vector>
+
 #include <libhal-armcortex/system_control.hpp>
 
+#include "dwt_counter_reg.hpp"
 #include "helper.hpp"
 
 #include <boost/ut.hpp>
@@ -31,6 +34,36 @@ enum class my_irq : irq_t
   spi7 = 63,
   max,
 };
+
+void uart0_handler()
+{
+  while (true) {
+    continue;
+  }
+}
+
+std::uint32_t fake_core = 0;
+
+std::uint32_t fake_core_id()
+{
+  return fake_core;
+}
+
+bool preempt_with_systick = false;
+
+void fake_systick_handler()
+{
+  dwt->cyccnt = dwt->cyccnt + 30;
+}
+
+void fake_uart0_handler()
+{
+  dwt->cyccnt = dwt->cyccnt + 100;
+  if (preempt_with_systick) {
+    scb->icsr = hal::value(irq::systick) - core_interrupts;
+    get_vector_table()[hal::value(irq::systick)]();
+  }
+}
 }
 
 void interrupt_test()
@@ -373,11 +406,463 @@ void interrupt_test()
     expect(interrupt_vector_table_initialized());
   };
 
+  should("set_priority() & get_priority()") = [&] {
+    should("set_priority(my_irq::uart0)") = [&]() {
+      // Setup
+      constexpr auto priority = priority_level<3, 5>();
+      static_assert(priority == 0b1010'0000);
+
+      // Exercise
+      set_priority(my_irq::uart0, priority);
+
+      // Verify
+      expect(that % priority == nvic->ip[hal::value(my_irq::uart0)]);
+      expect(that % priority == get_priority(my_irq::uart0));
+    };
+
+    should("set_priority(irq::systick) & set_priority(irq::pend_sv)") = [&]() {
+      // Exercise
+      set_priority(irq::systick, 0x40);
+      set_priority(irq::pend_sv, 0xE0);
+      set_priority(irq::software_call, 0x20);
+
+      // Verify
+      expect(that % 0x40 == scb->shp[11]);
+      expect(that % 0xE0 == scb->shp[10]);
+      expect(that % 0x20 == scb->shp[7]);
+      expect(that % 0x40 == get_priority(irq::systick));
+      expect(that % 0xE0 == get_priority(irq::pend_sv));
+      expect(that % 0x20 == get_priority(irq::software_call));
+    };
+
+    should("set_priority(irq::hard_fault) does nothing") = [&]() {
+      // Setup
+      auto const old_scb = *scb;
+
+      // Exercise
+      set_priority(irq::hard_fault, 0x40);
+      set_priority(irq::reset, 0x40);
+
+      // Verify
+      for (size_t i = 0; i < old_scb.shp.size(); i++) {
+        expect(that % old_scb.shp.at(i) == scb->shp.at(i));
+      }
+      expect(that % 0 == get_priority(irq::hard_fault));
+    };
+
+    should("set_priority(100) fail") = [&]() {
+      // Setup
+      auto const old_nvic = *nvic;
+
+      // Exercise
+      set_priority(100, 0x40);
+
+      // Verify
+      for (size_t i = 0; i < old_nvic.ip.size(); i++) {
+        expect(that % old_nvic.ip.at(i) == nvic->ip.at(i));
+      }
+      expect(that % 0 == get_priority(100));
+    };
+  };
+
+  should("set_priority_grouping()") = [&] {
+    // Setup
+    scb->aircr = 0xFA05'0000;
+
+    // Exercise
+    set_priority_grouping(5);
+
+    // Verify
+    expect(that % 0x05FA'0500 == scb->aircr);
+    expect(that % 5 == get_priority_grouping());
+  };
+
   should("disable_all_interrupts() & enable_all_interrupts() works") = [&] {
     // these are empty on host builds as the instruction for these will not work
     // any host that isn't a cortex-m mcu.
     disable_all_interrupts();
     enable_all_interrupts();
   };
+
+  should("initialize_interrupts(static_vector_table)") = [&] {
+    // Setup
+    static constexpr auto vectors =
+      static_vector_table<my_irq::max>().bind(my_irq::uart0, uart0_handler);
+    constexpr auto uart0 = hal::value(my_irq::uart0);
+    constexpr auto nmi_index = static_cast<std::size_t>(
+      hal::value(irq::non_maskable_interrupt) - core_interrupts);
+    static_assert(vectors.vectors.size() + nmi_index ==
+                  static_cast<std::size_t>(my_irq::max) - core_interrupts);
+    static_assert(vectors.vectors[14 + uart0] == &uart0_handler);
+    static_assert(vectors.vectors[1] == &hard_fault_handler);
+
+    revert_interrupt_vector_table();
+
+    // Exercise
+    initialize_interrupts(vectors);
+
+    // Verify
+    auto const vtor_expected =
+      reinterpret_cast<std::intptr_t>(vectors.vectors.data()) -
+      static_cast<std::intptr_t>(nmi_index * sizeof(interrupt_pointer));
+    expect(that % vtor_expected == scb->vtor);
+    expect(interrupt_vector_table_initialized());
+    expect(that % static_cast<std::size_t>(my_irq::max) ==
+           get_vector_table().size());
+    expect(that % &uart0_handler == get_vector_table()[uart0]);
+    expect(that % &hard_fault_handler ==
+           get_vector_table()[hal::value(irq::hard_fault)]);
+    expect(that % &default_interrupt_handler ==
+           get_vector_table()[hal::value(irq::systick)]);
+
+    // Verify: Only the handler bound at compile time can be enabled
+    interrupt_pointer dummy_handler = +[]() {};
+    enable_interrupt(my_irq::spi7, dummy_handler);
+    expect(not verify_vector_enabled(my_irq::spi7, dummy_handler));
+    enable_interrupt(my_irq::uart0, uart0_handler);
+    expect(verify_vector_enabled(my_irq::uart0, uart0_handler));
+
+    // Verify: RAM vector tables do not replace the static vector table
+    initialize_interrupts<my_irq::max>();
+    expect(that % vtor_expected == scb->vtor);
+
+    // Cleanup
+    revert_interrupt_vector_table();
+    initialize_interrupts<my_irq::max>();
+  };
+
+  should("initialize_interrupt_statistics()") = [&] {
+    // Setup
+    auto stub_out_core = stub_out_registers(&core);
+    auto stub_out_dwt = stub_out_registers(&dwt);
+    constexpr auto uart0 = hal::value(my_irq::uart0);
+    constexpr auto systick = hal::value(irq::systick);
+    constexpr auto uart0_index = uart0 - core_interrupts;
+    constexpr auto systick_index = systick - core_interrupts;
+    enable_interrupt(my_irq::uart0, fake_uart0_handler);
+    expect(that % 0 == get_interrupt_statistics().size());
+
+    // Exercise
+    initialize_interrupt_statistics<my_irq::max>();
+    enable_interrupt(irq::systick, fake_systick_handler);
+
+    // Verify
+    auto const statistics = get_interrupt_statistics();
+    expect(that % (static_cast<std::size_t>(my_irq::max) - core_interrupts) ==
+           statistics.size());
+    expect(that % enable_cycle_count == dwt->ctrl);
+    expect(that % &fake_uart0_handler != get_vector_table()[uart0]);
+    expect(that % &fake_systick_handler != get_vector_table()[systick]);
+    expect(that % get_vector_table()[uart0] == get_vector_table()[systick]);
+    expect(verify_vector_enabled(my_irq::uart0, fake_uart0_handler));
+    expect(verify_vector_enabled(irq::systick, fake_systick_handler));
+
+    // Exercise: handlers which rely on the state on exception entry
+    enable_interrupt(irq::pend_sv, fake_systick_handler);
+    enable_interrupt(irq::hard_fault, fake_uart0_handler);
+    enable_interrupt(irq::non_maskable_interrupt, fake_uart0_handler);
+
+    // Verify: they are installed directly into the vector table
+    expect(that % &fake_uart0_handler ==
+           get_vector_table()[hal::value(irq::non_maskable_interrupt)]);
+    expect(that % &fake_systick_handler ==
+           get_vector_table()[hal::value(irq::pend_sv)]);
+    expect(that % &fake_uart0_handler ==
+           get_vector_table()[hal::value(irq::hard_fault)]);
+    expect(verify_vector_enabled(irq::pend_sv, fake_systick_handler));
+    expect(that % get_vector_table()[uart0] !=
+           get_vector_table()[hal::value(irq::software_call)]);
+
+    // Exercise: uart0 fires
+    scb->icsr = uart0_index;
+    get_vector_table()[uart0]();
+
+    // Verify
+    expect(that % 1 == statistics[uart0_index].entries);
+    expect(that % 100 == statistics[uart0_index].total_cycles);
+    expect(that % 100 == statistics[uart0_index].max_cycles);
+    expect(that % 1 == statistics[uart0_index].max_nesting);
+
+    // Exercise: uart0 fires and is preempted by systick
+    preempt_with_systick = true;
+    scb->icsr = uart0_index;
+    get_vector_table()[uart0]();
+    preempt_with_systick = false;
+
+    // Verify: The time spent in systick is not counted against uart0
+    expect(that % 2 == statistics[uart0_index].entries);
+    expect(that % 200 == statistics[uart0_index].total_cycles);
+    expect(that % 100 == statistics[uart0_index].max_cycles);
+    expect(that % 1 == statistics[systick_index].entries);
+    expect(that % 30 == statistics[systick_index].total_cycles);
+    expect(that % 2 == statistics[systick_index].max_nesting);
+
+    // Exercise
+    reset_interrupt_statistics();
+
+    // Verify
+    expect(that % 0 == statistics[uart0_index].entries);
+    expect(that % 0 == statistics[systick_index].total_cycles);
+
+    // Cleanup
+    revert_interrupt_vector_table();
+    expect(that % 0 == get_interrupt_statistics().size());
+    initialize_interrupts<my_irq::max>();
+  };
+
+  should("irq_set & enable_interrupts()") = [&] {
+    // Setup
+    static constexpr irq_set group(my_irq::uart0, 3, my_irq::spi7);
+    static constexpr auto wider = group.with(100).with(irq_t{ 40 });
+    static_assert(group.mask(0) == (1U << 3));
+    static_assert(group.mask(1) == ((1U << (55 - 32)) | (1U << (63 - 32))));
+    static_assert(wider.contains(100) && wider.contains(40));
+    static_assert(not group.contains(4) && not group.contains(-1));
+    initialize_interrupts<my_irq::max>();
+    nvic->iser = {};
+    nvic->icer = {};
+    nvic->ispr = {};
+    nvic->icpr = {};
+
+    // Exercise
+    enable_interrupts(wider);
+    disable_interrupts(group);
+    pend_interrupts(group);
+    clear_pending_interrupts(group);
+
+    // Verify: irq 100 is beyond the vector table and is ignored
+    auto const expected_word1 = group.mask(1) | (1U << (40 - 32));
+    expect(that % (1U << 3) == nvic->iser[0]);
+    expect(that % expected_word1 == nvic->iser[1]);
+    expect(that % 0 == nvic->iser[3]);
+    expect(that % group.mask(1) == nvic->icer[1]);
+    expect(that % group.mask(0) == nvic->ispr[0]);
+    expect(that % group.mask(1) == nvic->icpr[1]);
+  };
+
+  should("enable_interrupts(bindings)") = [&] {
+    // Setup
+    initialize_interrupts<my_irq::max>();
+    nvic->iser = {};
+    std::array<interrupt_binding, 4> const bindings{ {
+      { .irq = hal::value(my_irq::uart0), .handler = fake_uart0_handler },
+      { .irq = 5, .handler = fake_uart0_handler },
+      { .irq = hal::value(irq::systick), .handler = fake_systick_handler },
+      { .irq = 100, .handler = fake_uart0_handler },
+    } };
+
+    // Exercise
+    enable_interrupts(bindings);
+
+    // Verify
+    expect(verify_vector_enabled(my_irq::uart0, fake_uart0_handler));
+    expect(verify_vector_enabled(5, fake_uart0_handler));
+    expect(verify_vector_enabled(irq::systick, fake_systick_handler));
+    expect(that % (1U << 5) == nvic->iser[0]);
+    expect(that % (1U << (55 - 32)) == nvic->iser[1]);
+    expect(that % 0 == nvic->iser[3]);
+  };
+
+  should("trigger_interrupt() & pending queries") = [&] {
+    // Setup
+    initialize_interrupts<my_irq::max>();
+    nvic->ispr = {};
+    nvic->icpr = {};
+    nvic->stir = 0;
+    scb->icsr = 0;
+
+    // Exercise
+    trigger_interrupt(my_irq::uart0);
+    trigger_interrupt(100);
+
+    // Verify: the host build uses the set pending registers
+    expect(that % (1U << (55 - 32)) == nvic->ispr[1]);
+    expect(is_pending(my_irq::uart0));
+    expect(not is_pending(my_irq::spi7));
+    expect(not is_pending(100));
+    expect(that % 0 == nvic->ispr[3]);
+
+    // Exercise
+    clear_pending(my_irq::uart0);
+
+    // Verify
+    expect(that % (1U << (55 - 32)) == nvic->icpr[1]);
+
+    // Exercise
+    trigger_interrupt(irq::pend_sv);
+
+    // Verify
+    expect(that % (1U << 28) == scb->icsr);
+    expect(is_pending(irq::pend_sv));
+    expect(not is_pending(irq::systick));
+
+    // Exercise
+    clear_pending(irq::pend_sv);
+    trigger_interrupt(irq::hard_fault);
+
+    // Verify
+    expect(that % (1U << 27) == scb->icsr);
+  };
+
+  should("is_active()") = [&] {
+    // Setup
+    initialize_interrupts<my_irq::max>();
+    nvic->iabr = {};
+    nvic->iabr[1] = 1U << (63 - 32);
+    scb->shcsr = 1U << 11;
+
+    // Exercise & Verify
+    expect(is_active(my_irq::spi7));
+    expect(not is_active(my_irq::uart0));
+    expect(is_active(irq::systick));
+    expect(not is_active(irq::pend_sv));
+    expect(not is_active(irq::hard_fault));
+    expect(not is_active(100));
+  };
+
+  should("set_core_id_source() gives each core its own state") = [&] {
+    // Setup
+    initialize_interrupts<my_irq::max>();
+    auto const core0_table = get_vector_table();
+    auto const core0_handler = core0_table[40];
+    set_core_id_source(fake_core_id);
+    fake_core = 1;
+
+    // Verify: core 1 has not initialized its interrupts
+    expect(that % 1 == current_core());
+    expect(not interrupt_vector_table_initialized());
+
+    // Exercise & Verify: tables are only allocated for core 0 by default
+    initialize_interrupts<my_irq::max>();
+    expect(not interrupt_vector_table_initialized());
+
+    // Exercise
+    initialize_interrupts<my_irq::max, 2>();
+    enable_interrupt(40, uart0_handler);
+
+    // Verify
+    expect(core0_table.data() != get_vector_table().data());
+    expect(uart0_handler == get_vector_table()[40]);
+
+    // Exercise
+    fake_core = 0;
+
+    // Verify: core 0's table is untouched by core 1
+    expect(core0_table.data() == get_vector_table().data());
+    expect(core0_handler == get_vector_table()[40]);
+
+    // Exercise & Verify: ids that are out of range are treated as core 0
+    fake_core = max_cores;
+    expect(that % 0 == current_core());
+
+    // Cleanup
+    fake_core = 1;
+    revert_interrupt_vector_table();
+    set_core_id_source(nullptr);
+    expect(that % 0 == current_core());
+  };
+
+  should("attach_interrupt() & detach_interrupts()") = [&] {
+    // Setup
+    constexpr auto uart0 = hal::value(my_irq::uart0);
+    std::vector<int> calls;
+    initialize_interrupts<my_irq::max>();
+    nvic->iser = {};
+    nvic->icer = {};
+
+    // Exercise & Verify
+    expect(throws([] { attach_interrupt(my_irq::uart0, [] {}); }));
+
+    // Exercise
+    initialize_irq_dispatch<my_irq::max, 2>();
+    attach_interrupt(my_irq::uart0, [&calls] { calls.push_back(1); });
+    attach_interrupt(my_irq::uart0, [&calls] { calls.push_back(2); });
+    attach_interrupt(irq::systick, [&calls] { calls.push_back(3); });
+    attach_interrupt(irq::reset, [&calls] { calls.push_back(4); });
+    attach_interrupt(100, [&calls] { calls.push_back(5); });
+
+    // Verify
+    expect(verify_vector_enabled(my_irq::uart0, dispatch_irq_callbacks));
+    expect(verify_vector_enabled(irq::systick, dispatch_irq_callbacks));
+    expect(that % (1U << (uart0 - 32)) == nvic->iser[1]);
+    expect(throws<hal::resource_unavailable_try_again>(
+      [] { attach_interrupt(my_irq::uart0, [] {}); }));
+
+    // Exercise: uart0 and systick fire
+    scb->icsr = uart0 - core_interrupts;
+    get_vector_table()[uart0]();
+    scb->icsr = hal::value(irq::systick) - core_interrupts;
+    get_vector_table()[hal::value(irq::systick)]();
+
+    // Verify: callbacks sharing an irq are called in the order attached
+    expect(that % std::vector<int>{ 1, 2, 3 } == calls);
+
+    // Exercise
+    detach_interrupts(my_irq::uart0);
+    scb->icsr = uart0 - core_interrupts;
+    get_vector_table()[uart0]();
+
+    // Verify
+    expect(that % (1U << (uart0 - 32)) == nvic->icer[1]);
+    expect(that % std::vector<int>{ 1, 2, 3 } == calls);
+
+    // Exercise: the irq can be attached to again
+    attach_interrupt(my_irq::uart0, [&calls] { calls.push_back(6); });
+    get_vector_table()[uart0]();
+
+    // Verify
+    expect(that % std::vector<int>{ 1, 2, 3, 6 } == calls);
+
+    // Cleanup
+    detach_interrupts(my_irq::uart0);
+    detach_interrupts(irq::systick);
+  };
+
+  should("register access budgets") = [&] {
+    // Setup
+    initialize_interrupts<my_irq::max>();
+    mmio_recorder recorder;
+
+    // Exercise
+    enable_interrupt(my_irq::uart0, uart0_handler);
+
+    // Verify: a single NVIC write and VTOR is never read
+    expect(that % 1 == recorder.writes(nvic->iser[1]));
+    expect(that % 1 == recorder.accesses().size());
+    expect(that % 0 == recorder.reads(scb->vtor));
+    expect(that % sizeof(std::uint32_t) == recorder.accesses()[0].width);
+
+    // Exercise
+    recorder.clear();
+    disable_interrupt(my_irq::uart0);
+    trigger_interrupt(my_irq::uart0);
+    clear_pending(my_irq::uart0);
+
+    // Verify: each is a single write, without a read-modify-write
+    expect(that % 3 == recorder.writes(*nvic));
+    expect(that % 0 == recorder.reads(*nvic));
+    expect(that % 0 == recorder.reads(*scb));
+
+    // Exercise
+    recorder.clear();
+    [[maybe_unused]] auto const pending = is_pending(my_irq::uart0);
+    [[maybe_unused]] auto const enabled =
+      verify_vector_enabled(my_irq::uart0, uart0_handler);
+
+    // Verify
+    expect(that % 1 == recorder.reads(nvic->ispr[1]));
+    expect(that % 1 == recorder.reads(nvic->iser[1]));
+    expect(that % 0 == recorder.writes(*nvic));
+    expect(that % 0 == recorder.reads(scb->vtor));
+
+    // Exercise
+    recorder.clear();
+    set_priority(my_irq::uart0, 0x40);
+
+    // Verify
+    expect(that % 1 == recorder.writes(nvic->ip[55]));
+    expect(that % sizeof(std::uint8_t) == recorder.accesses()[0].width);
+    expect(that % 1 == recorder.accesses().size());
+  };
 };
 }  // namespace hal::cortex_m
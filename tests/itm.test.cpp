@@ -0,0 +1,121 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/itm.hpp>
+
+#include <array>
+#include <cstdint>
+
+#include "dwt_counter_reg.hpp"
+#include "helper.hpp"
+#include "itm_reg.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void itm_test()
+{
+  using namespace boost::ut;
+
+  auto stub_out_core = stub_out_registers(&core);
+  auto stub_out_dwt = stub_out_registers(&dwt);
+  auto stub_out_itm = stub_out_registers(&itm);
+  auto stub_out_tpiu = stub_out_registers(&tpiu);
+
+  "initialize_itm()"_test = []() {
+    // Exercise
+    initialize_itm({ .trace_clock = 64'000'000.0f });
+
+    // Verify
+    expect(that % core_trace_enable == core->demcr);
+    expect(that % 1 == tpiu->cspsr);
+    expect(that % swo_nrz_protocol == tpiu->sppr);
+    expect(that % 31 == tpiu->acpr);
+    expect(that % formatter_bypass == tpiu->ffcr);
+    expect(that % itm_unlock_key == itm->lar);
+    expect(that % 0x0001'0005 == itm->tcr);
+    expect(that % 0b1 == itm->ter[0]);
+    expect(that % 0 == dwt->ctrl);
+  };
+
+  "initialize_itm() with timestamps & PC sampling"_test = []() {
+    // Exercise
+    initialize_itm({ .trace_clock = 480'000'000.0f,
+                     .baud_rate = 12'000'000.0f,
+                     .enabled_ports = 0b101,
+                     .timestamps = true,
+                     .pc_sampling = true });
+
+    // Verify
+    expect(that % 39 == tpiu->acpr);
+    expect(that % 0x0001'000F == itm->tcr);
+    expect(that % 0b101 == itm->ter[0]);
+    expect(that % 0x161F == dwt->ctrl);
+  };
+
+  "initialize_itm() with an unreachable baud rate"_test = []() {
+    expect(throws([] {
+      initialize_itm(
+        { .trace_clock = 1'000'000.0f, .baud_rate = 2'000'000.0f });
+    }));
+  };
+
+  "itm_write()"_test = []() {
+    // Setup
+    initialize_itm({ .trace_clock = 64'000'000.0f });
+    itm->stim[0] = 1;
+    itm->stim[1] = 1;
+
+    // Exercise
+    itm_write(0, 0x1234'5679);
+    itm_write(1, 0x1234'5679);
+
+    // Verify
+    expect(itm_port_enabled(0));
+    expect(not itm_port_enabled(1));
+    expect(that % 0x1234'5679 == itm->stim[0]);
+    // Port 1 is disabled so nothing is written
+    expect(that % 1 == itm->stim[1]);
+  };
+
+  "itm_serial::write()"_test = []() {
+    // Setup
+    initialize_itm({ .trace_clock = 64'000'000.0f });
+    itm->stim[0] = 1;
+    itm_serial test_subject(0);
+    std::array<hal::byte, 5> const message{ 'a', 'b', 'c', 'd', 'e' };
+
+    // Exercise
+    auto const result = test_subject.write(message);
+    test_subject.flush();
+
+    // Verify: "abcd" as a single word followed by "e" as a byte
+    expect(that % message.size() == result.data.size());
+    expect(that % 0x6463'6265 == itm->stim[0]);
+  };
+
+  "itm_serial::read()"_test = []() {
+    // Setup
+    itm_serial test_subject(0);
+    std::array<hal::byte, 4> buffer{};
+
+    // Exercise
+    auto const result = test_subject.read(buffer);
+
+    // Verify
+    expect(that % 0 == result.data.size());
+    expect(that % 0 == result.available);
+  };
+}
+}  // namespace hal::cortex_m
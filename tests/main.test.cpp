@@ -16,6 +16,22 @@ namespace hal::cortex_m {
 extern void dwt_test();
 extern void systick_timer_test();
 extern void interrupt_test();
+extern void startup_test();
+extern void system_control_test();
+extern void mpu_test();
+extern void dwt_profiler_test();
+extern void dwt_comparator_test();
+extern void cycle_probe_test();
+extern void itm_test();
+extern void timer_queue_test();
+extern void systick_counter_test();
+extern void frequency_scale_test();
+extern void deferred_work_test();
+extern void context_switch_test();
+extern void idle_test();
+extern void multicore_test();
+extern void fault_test();
+extern void exceptions_test();
 }  // namespace hal::cortex_m
 
 int main()
@@ -25,4 +41,20 @@ int main()
   hal::cortex_m::interrupt_test();
   hal::cortex_m::dwt_test();
   hal::cortex_m::systick_timer_test();
+  hal::cortex_m::startup_test();
+  hal::cortex_m::system_control_test();
+  hal::cortex_m::mpu_test();
+  hal::cortex_m::dwt_profiler_test();
+  hal::cortex_m::dwt_comparator_test();
+  hal::cortex_m::cycle_probe_test();
+  hal::cortex_m::itm_test();
+  hal::cortex_m::timer_queue_test();
+  hal::cortex_m::systick_counter_test();
+  hal::cortex_m::frequency_scale_test();
+  hal::cortex_m::deferred_work_test();
+  hal::cortex_m::context_switch_test();
+  hal::cortex_m::idle_test();
+  hal::cortex_m::multicore_test();
+  hal::cortex_m::fault_test();
+  hal::cortex_m::exceptions_test();
 }
@@ -0,0 +1,133 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/mpu.hpp>
+
+#include <array>
+#include <cstdint>
+
+#include "helper.hpp"
+#include "mpu_reg.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void mpu_test()
+{
+  using namespace boost::ut;
+
+  auto stub_out_mpu = stub_out_registers(&mpu);
+
+  should("make_mpu_table() for ARMv7-M") = [] {
+    // Exercise
+    constexpr auto table = make_mpu_table<mpu_architecture::armv7m>(std::array{
+      mpu_region{ .base = 0x2000'0000,
+                  .size = 512 * 1024,
+                  .execute_never = true },
+      mpu_region{ .base = 0x2007'0000,
+                  .size = 64 * 1024,
+                  .type = mpu_memory_type::normal_non_cacheable,
+                  .access = mpu_access::privileged_read_write,
+                  .shareable = true },
+      mpu_region{ .base = 0x4000'0000,
+                  .size = 32,
+                  .type = mpu_memory_type::device,
+                  .access = mpu_access::read_only },
+    });
+
+    // Verify
+    expect(mpu_architecture::armv7m == table.architecture);
+    expect(that % 0x2000'0000 == table.regions[0].rbar);
+    // XN, AP = 0b011, TEX = 0b001, C, B, SIZE = 18, ENABLE
+    expect(that % 0x130B'0025 == table.regions[0].rasr_or_rlar);
+    expect(that % 0x2007'0000 == table.regions[1].rbar);
+    // AP = 0b001, TEX = 0b001, S, SIZE = 15, ENABLE
+    expect(that % 0x010C'001F == table.regions[1].rasr_or_rlar);
+    expect(that % 0x4000'0000 == table.regions[2].rbar);
+    // AP = 0b110, B, SIZE = 4, ENABLE
+    expect(that % 0x0601'0009 == table.regions[2].rasr_or_rlar);
+  };
+
+  should("make_mpu_table() for ARMv8-M") = [] {
+    // Exercise
+    constexpr auto table = make_mpu_table<mpu_architecture::armv8m>(std::array{
+      mpu_region{ .base = 0x2000'0000,
+                  .size = 0x100,
+                  .type = mpu_memory_type::normal_non_cacheable,
+                  .shareable = true,
+                  .execute_never = true },
+      mpu_region{ .base = 0x0800'0000,
+                  .size = 96 * 1024,
+                  .access = mpu_access::privileged_read_only },
+    });
+
+    // Verify
+    expect(mpu_architecture::armv8m == table.architecture);
+    // SH = 0b11, AP = 0b01, XN
+    expect(that % 0x2000'001B == table.regions[0].rbar);
+    // LIMIT, AttrIndx = 2, EN
+    expect(that % 0x2000'00E5 == table.regions[0].rasr_or_rlar);
+    // AP = 0b10
+    expect(that % 0x0800'0004 == table.regions[1].rbar);
+    // LIMIT, AttrIndx = 4, EN
+    expect(that % 0x0801'7FE9 == table.regions[1].rasr_or_rlar);
+  };
+
+  should("configure_mpu()") = [] {
+    // Setup
+    constexpr auto table = make_mpu_table(std::array{
+      mpu_region{ .base = 0x2000'0000, .size = 1024 },
+      mpu_region{ .base = 0x2000'0400, .size = 256 },
+    });
+    const_cast<std::uint32_t&>(mpu->type) = 8 << 8;
+    mpu->rbar = 0;
+    mpu->rasr_or_rlar = 0xFFFF'FFFF;
+
+    // Exercise
+    configure_mpu(table);
+
+    // Verify
+    expect(that % 8 == mpu_region_count());
+    // Unused regions 2 to 7 must be disabled
+    expect(that % 7 == mpu->rnr);
+    expect(that % 0 == mpu->rasr_or_rlar);
+    expect(that % table.regions[1].rbar == mpu->rbar);
+    expect(that % 0b101 == mpu->ctrl);
+
+    // Exercise
+    configure_mpu(table, false);
+
+    // Verify
+    expect(that % 0b001 == mpu->ctrl);
+
+    // Exercise
+    disable_mpu();
+
+    // Verify
+    expect(that % 0 == mpu->ctrl);
+  };
+
+  should("configure_mpu() rejects tables that do not fit the MPU") = [] {
+    // Setup
+    constexpr auto table = make_mpu_table(std::array{
+      mpu_region{ .base = 0x2000'0000, .size = 1024 },
+      mpu_region{ .base = 0x2000'0400, .size = 256 },
+    });
+    const_cast<std::uint32_t&>(mpu->type) = 1 << 8;
+
+    // Exercise & Verify
+    expect(throws([&table] { configure_mpu(table); }));
+  };
+}
+}  // namespace hal::cortex_m
@@ -0,0 +1,93 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/multicore.hpp>
+
+#include <cstdint>
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void multicore_test()
+{
+  using namespace boost::ut;
+
+  "core_doorbell"_test = []() {
+    // Setup
+    core_doorbell doorbell;
+
+    // Exercise & Verify
+    expect(not doorbell.answer());
+
+    // Exercise: multiple rings coalesce into a single answer
+    doorbell.ring();
+    doorbell.ring();
+
+    // Verify
+    expect(doorbell.answer());
+    expect(not doorbell.answer());
+
+    // Exercise & Verify: wait() returns at once for a ring that came first
+    doorbell.ring();
+    doorbell.wait();
+    expect(not doorbell.answer());
+  };
+
+  "core_mailbox::try_send() & core_mailbox::try_receive()"_test = []() {
+    // Setup
+    core_mailbox<std::uint32_t, 2> mailbox;
+    std::uint32_t message = 0;
+
+    // Exercise & Verify
+    expect(not mailbox.try_receive(message));
+    expect(mailbox.try_send(10));
+    expect(mailbox.try_send(20));
+    expect(that % 2 == mailbox.size());
+
+    // Exercise & Verify: the mailbox is full
+    expect(not mailbox.try_send(30));
+
+    // Exercise & Verify: messages are received in order
+    expect(mailbox.try_receive(message));
+    expect(that % 10 == message);
+    expect(mailbox.try_send(30));
+    expect(mailbox.try_receive(message));
+    expect(that % 20 == message);
+    expect(mailbox.try_receive(message));
+    expect(that % 30 == message);
+    expect(not mailbox.try_receive(message));
+    expect(that % 0 == mailbox.size());
+  };
+
+  "core_mailbox::send() & core_mailbox::receive()"_test = []() {
+    // Setup
+    struct message_t
+    {
+      std::uint16_t command;
+      std::uint32_t argument;
+    };
+    core_mailbox<message_t, 4> mailbox;
+
+    // Exercise
+    for (std::uint16_t i = 0; i < 16; i++) {
+      mailbox.send({ .command = i, .argument = i * 3U });
+      auto const received = mailbox.receive();
+
+      // Verify
+      expect(that % i == received.command);
+      expect(that % (i * 3U) == received.argument);
+    }
+  };
+}
+}  // namespace hal::cortex_m
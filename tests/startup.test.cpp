@@ -0,0 +1,153 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/startup.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void startup_test()
+{
+  using namespace boost::ut;
+
+  should("copy_section()") = [] {
+    // Setup
+    std::array<std::uint32_t, 7> source{};
+    std::array<std::uint32_t, 8> destination{};
+    for (std::uint32_t i = 0; i < source.size(); i++) {
+      source[i] = 0xAA00'0000 | i;
+    }
+    destination.fill(0xFFFF'FFFF);
+
+    // Exercise: 6 words & 2 bytes, covering the burst, word and byte paths
+    copy_section({ .start = destination.data(),
+                   .source = source.data(),
+                   .size = (6 * sizeof(std::uint32_t)) + 2 });
+
+    // Verify
+    for (std::uint32_t i = 0; i < 6; i++) {
+      expect(that % source[i] == destination[i]);
+    }
+    std::uint32_t partial_word = 0;
+    std::memcpy(&partial_word, &destination[6], sizeof(partial_word));
+    expect(that % (source[6] & 0x0000'FFFF) == (partial_word & 0x0000'FFFF));
+    expect(that % 0xFFFF'0000 == (partial_word & 0xFFFF'0000));
+    expect(that % 0xFFFF'FFFF == destination[7]);
+  };
+
+  should("zero_section()") = [] {
+    // Setup
+    std::array<std::uint32_t, 8> destination{};
+    destination.fill(0xFFFF'FFFF);
+
+    // Exercise
+    zero_section({ .start = destination.data(),
+                   .size = 5 * sizeof(std::uint32_t),
+                   .flags = 0 });
+
+    // Verify
+    for (std::uint32_t i = 0; i < 5; i++) {
+      expect(that % 0 == destination[i]);
+    }
+    for (std::uint32_t i = 5; i < destination.size(); i++) {
+      expect(that % 0xFFFF'FFFF == destination[i]);
+    }
+  };
+
+  should("initialize_sections()") = [] {
+    // Setup
+    std::array<std::uint32_t, 4> source{ 1, 2, 3, 4 };
+    std::array<std::uint32_t, 4> data{};
+    std::array<std::uint32_t, 4> bss{};
+    std::array<std::uint32_t, 4> backup{};
+    bss.fill(0xFFFF'FFFF);
+    backup.fill(0xFFFF'FFFF);
+
+    std::array const copy_table{
+      copy_region{ .start = data.data(),
+                   .source = source.data(),
+                   .size = sizeof(source) },
+    };
+    std::array const zero_table{
+      zero_region{ .start = bss.data(), .size = sizeof(bss), .flags = 0 },
+      zero_region{ .start = backup.data(),
+                   .size = sizeof(backup),
+                   .flags = zero_region::preserve },
+    };
+
+    // Exercise
+    initialize_sections(copy_table, zero_table, startup_mode::lazy);
+
+    // Verify
+    expect(std::ranges::equal(source, data));
+    expect(std::ranges::all_of(bss, [](auto p) { return p == 0; }));
+    expect(
+      std::ranges::all_of(backup, [](auto p) { return p == 0xFFFF'FFFF; }));
+
+    // Exercise
+    initialize_sections(copy_table, zero_table, startup_mode::cold);
+
+    // Verify
+    expect(std::ranges::all_of(backup, [](auto p) { return p == 0; }));
+  };
+
+  should("fill_words()") = [] {
+    // Setup
+    std::array<std::uint32_t, 8> destination{};
+
+    // Exercise: 7 words, covering the burst and word paths
+    fill_words(std::span(destination).first(7), 0x1234'5678);
+
+    // Verify
+    for (std::uint32_t i = 0; i < 7; i++) {
+      expect(that % 0x1234'5678 == destination[i]);
+    }
+    expect(that % 0 == destination[7]);
+  };
+
+  should("paint_stack() & stack_high_water_mark()") = [] {
+    // Setup
+    std::array<std::uint32_t, 16> stack{};
+
+    // Exercise
+    paint_stack(stack);
+
+    // Verify
+    expect(std::ranges::all_of(
+      stack, [](auto p) { return p == stack_paint_pattern; }));
+    expect(that % 0 == stack_high_water_mark(stack));
+
+    // Exercise: stacks grow down from the end of the span
+    stack[15] = 0;
+    stack[12] = 0;
+    // Words that happen to hold the pattern above the deepest use count as used
+    stack[13] = stack_paint_pattern;
+
+    // Verify
+    expect(that % (4 * sizeof(std::uint32_t)) == stack_high_water_mark(stack));
+
+    // Exercise
+    stack[0] = 0;
+
+    // Verify
+    expect(that % sizeof(stack) == stack_high_water_mark(stack));
+    expect(that % 0 == stack_high_water_mark({}));
+  };
+};
+}  // namespace hal::cortex_m
@@ -0,0 +1,183 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/system_control.hpp>
+
+#include <array>
+#include <cstdint>
+
+#include "helper.hpp"
+#include "system_controller_reg.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+namespace {
+void set_cache_geometry(std::uint32_t p_sets, std::uint32_t p_ways)
+{
+  auto ccsidr = hal::bit_value<std::uint32_t>(0)
+                  .insert<cache_size_id::number_of_sets>(p_sets - 1)
+                  .insert<cache_size_id::associativity>(p_ways - 1)
+                  .get();
+  const_cast<mmio<std::uint32_t>&>(scb->ccsidr) = ccsidr;
+}
+
+std::uint32_t address_of(hal::byte const* p_address)
+{
+  auto const address = reinterpret_cast<std::uintptr_t>(p_address);
+  return static_cast<std::uint32_t>(address);
+}
+}  // namespace
+
+void system_control_test()
+{
+  using namespace boost::ut;
+
+  auto stub_out_scb = stub_out_registers(&scb);
+  auto stub_out_fpu = stub_out_registers(&fpu);
+
+  should("set_floating_point_stacking()") = [] {
+    // Setup: reset value of FPCCR, lazy stacking
+    fpu->fpccr = 0xC000'0000;
+    expect(floating_point_stacking::lazy == get_floating_point_stacking());
+
+    // Exercise
+    set_floating_point_stacking(floating_point_stacking::always);
+
+    // Verify
+    expect(that % 0x8000'0000 == fpu->fpccr);
+    expect(floating_point_stacking::always == get_floating_point_stacking());
+
+    // Exercise
+    set_floating_point_stacking(floating_point_stacking::none);
+
+    // Verify
+    expect(that % 0 == fpu->fpccr);
+    expect(floating_point_stacking::none == get_floating_point_stacking());
+
+    // Exercise
+    set_floating_point_stacking(floating_point_stacking::lazy);
+
+    // Verify
+    expect(that % 0xC000'0000 == fpu->fpccr);
+    expect(not lazy_floating_point_save_pending());
+
+    // Exercise
+    fpu->fpccr = fpu->fpccr | 1U;
+
+    // Verify
+    expect(lazy_floating_point_save_pending());
+  };
+
+  should("is_extended_exception_frame()") = [] {
+    static_assert(is_extended_exception_frame(0xFFFF'FFED));
+    static_assert(not is_extended_exception_frame(0xFFFF'FFFD));
+    static_assert(not is_extended_exception_frame(0xFFFF'FFF9));
+  };
+
+  should("enable_data_cache() & disable_data_cache()") = [] {
+    // Exercise
+    enable_data_cache();
+
+    // Verify
+    expect(that % 1 ==
+           hal::bit_extract<configuration_control::data_cache_enable>(
+             scb->ccr));
+
+    // Exercise
+    disable_data_cache();
+
+    // Verify
+    expect(that % 0 ==
+           hal::bit_extract<configuration_control::data_cache_enable>(
+             scb->ccr));
+  };
+
+  should("enable_instruction_cache() & disable_instruction_cache()") = [] {
+    // Exercise
+    enable_instruction_cache();
+
+    // Verify
+    expect(that % 1 ==
+           hal::bit_extract<configuration_control::instruction_cache_enable>(
+             scb->ccr));
+
+    // Exercise
+    disable_instruction_cache();
+
+    // Verify
+    expect(that % 0 ==
+           hal::bit_extract<configuration_control::instruction_cache_enable>(
+             scb->ccr));
+  };
+
+  should("clean_dcache() by address") = [] {
+    // Setup
+    set_cache_geometry(128, 4);
+    alignas(cache_line_size) std::array<hal::byte, 96> buffer{};
+
+    // Exercise: unaligned region covering the first and second line
+    clean_dcache(std::span(buffer).subspan(4, 40));
+
+    // Verify: last line cleaned was the second line
+    expect(that % (address_of(buffer.data()) + cache_line_size) ==
+           scb->dccmvac);
+  };
+
+  should("invalidate_dcache() by address") = [] {
+    // Setup
+    set_cache_geometry(128, 4);
+    alignas(cache_line_size) std::array<hal::byte, 128> buffer{};
+    scb->dcimvac = 0;
+    scb->dccimvac = 0;
+
+    // Exercise
+    invalidate_dcache(std::span(buffer).subspan(16, 88));
+
+    // Verify: edge lines are cleaned & invalidated, the rest are invalidated
+    expect(that % (address_of(buffer.data()) + (3 * cache_line_size)) ==
+           scb->dccimvac);
+    expect(that % (address_of(buffer.data()) + (2 * cache_line_size)) ==
+           scb->dcimvac);
+  };
+
+  should("clean_invalidate_dcache() by address") = [] {
+    // Setup
+    set_cache_geometry(128, 4);
+    alignas(cache_line_size) std::array<hal::byte, 64> buffer{};
+
+    // Exercise
+    clean_invalidate_dcache(buffer);
+
+    // Verify
+    expect(that % (address_of(buffer.data()) + cache_line_size) ==
+           scb->dccimvac);
+  };
+
+  should("clean_dcache() larger than cache uses set/way") = [] {
+    // Setup
+    set_cache_geometry(1, 1);
+    std::array<hal::byte, 64> buffer{};
+    scb->dccsw = 0xFFFF'FFFF;
+    scb->dccmvac = 0xFFFF'FFFF;
+
+    // Exercise
+    clean_dcache(buffer);
+
+    // Verify
+    expect(that % 0 == scb->dccsw);
+    expect(that % 0xFFFF'FFFF == scb->dccmvac);
+  };
+};
+}  // namespace hal::cortex_m
@@ -0,0 +1,196 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/systick_counter.hpp>
+
+#include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/enum.hpp>
+
+#include "helper.hpp"
+#include "system_controller_reg.hpp"
+#include "systick_timer_reg.hpp"
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+void systick_counter_test()
+{
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+
+  auto saved_registers = setup_interrupts_for_unit_testing();
+  auto stub_out_sys_tick = stub_out_registers(&sys_tick);
+  initialize_interrupts<1>();
+
+  auto const isr = [] { get_vector_table()[hal::value(irq::systick)](); };
+  auto const set_current_value = [](std::uint32_t p_value) {
+    // Writes to current_value are used as-is by the register stub
+    sys_tick->current_value = p_value;
+  };
+
+  should("systick_counter::systick_counter()") = [&] {
+    // Setup
+    set_priority(irq::systick, 0xE0);
+
+    // Exercise
+    systick_counter test_subject(48'000'000.0f);
+
+    // Verify
+    expect(that % 0 == get_priority(irq::systick));
+    expect(that % 0x00FF'FFFF == sys_tick->reload);
+    expect(that % 0b111 == sys_tick->control);
+    expect(that % 48'000'000.0f == test_subject.frequency());
+  };
+
+  should("systick_counter::uptime()") = [&] {
+    // Setup
+    systick_counter test_subject(48'000'000.0f);
+
+    // Exercise & Verify
+    set_current_value(0x00FF'FFFF);
+    expect(that % 0 == test_subject.uptime());
+
+    set_current_value(0x00FF'FF00);
+    expect(that % 0xFF == test_subject.uptime());
+
+    isr();
+    isr();
+    set_current_value(0x00FF'FFFE);
+    expect(that % ((2ULL << 24) | 1U) == test_subject.uptime());
+
+    // Exercise: the counter wrapped but the interrupt has not run yet
+    scb->icsr = 1 << 26;
+    set_current_value(0x00FF'FFF0);
+
+    // Verify
+    expect(that % ((3ULL << 24) | 0xFU) == test_subject.uptime());
+
+    // Exercise: the interrupt runs
+    scb->icsr = 0;
+    isr();
+
+    // Verify: the uptime is unchanged
+    expect(that % ((3ULL << 24) | 0xFU) == test_subject.uptime());
+  };
+
+  should("systick_counter::schedule() within the current period") = [&] {
+    // Setup
+    systick_counter test_subject(48'000'000.0f);
+    int calls = 0;
+    set_current_value(0x00FF'FFFF);
+
+    // Exercise
+    test_subject.schedule([&calls]() { calls++; }, 1ms);
+
+    // Verify: the counter restarts with a period that ends on the deadline
+    expect(that % 47'999 == sys_tick->reload);
+    expect(that % 0 == sys_tick->current_value);
+    expect(test_subject.is_running());
+
+    // Exercise: the period ends
+    set_current_value(47'999);
+    isr();
+
+    // Verify
+    expect(that % 1 == calls);
+    expect(not test_subject.is_running());
+    expect(that % 0x00FF'FFFF == sys_tick->reload);
+    expect(that % 48'001 == test_subject.uptime());
+  };
+
+  should("systick_counter::schedule() across multiple periods") = [&] {
+    // Setup
+    systick_counter test_subject(48'000'000.0f);
+    int calls = 0;
+    set_current_value(0x00FF'FFFF);
+
+    // Exercise
+    test_subject.schedule([&calls]() { calls++; }, 1s);
+
+    // Verify: the deadline is more than 2 periods away
+    expect(that % 0x00FF'FFFF == sys_tick->reload);
+
+    // Exercise
+    isr();
+
+    // Verify: the next period ends on the deadline
+    expect(that % 0 == calls);
+    expect(that % (48'000'000 - (2 << 24) - 1) == sys_tick->reload);
+
+    // Exercise
+    set_current_value(sys_tick->reload);
+    isr();
+
+    // Verify: the deadline is the end of the current period
+    expect(that % 0 == calls);
+    expect(that % 0x00FF'FFFF == sys_tick->reload);
+
+    // Exercise
+    set_current_value(0x00FF'FFFF);
+    isr();
+
+    // Verify
+    expect(that % 1 == calls);
+    expect(that % 48'000'000 == test_subject.uptime());
+  };
+
+  should("systick_counter::cancel()") = [&] {
+    // Setup
+    systick_counter test_subject(48'000'000.0f);
+    int calls = 0;
+    set_current_value(0x00FF'FFFF);
+    test_subject.schedule([&calls]() { calls++; }, 1ms);
+
+    // Exercise
+    test_subject.cancel();
+    set_current_value(47'999);
+    isr();
+
+    // Verify
+    expect(that % 0 == calls);
+    expect(not test_subject.is_running());
+    expect(that % 0x00FF'FFFF == sys_tick->reload);
+  };
+
+  should("systick_counter::cancel() with a wrap pending") = [&] {
+    // Setup
+    systick_counter test_subject(48'000'000.0f);
+    set_current_value(0x00FF'FFFF);
+    test_subject.schedule([]() {}, 1ms);
+
+    // Setup: the short period ended and the counter reloaded from it, but the
+    // interrupt has not run yet
+    scb->icsr = 1 << 26;
+    set_current_value(47'990);
+
+    // Exercise
+    test_subject.cancel();
+
+    // Verify: the pending wrap is accounted for with the period it reloaded
+    expect(that % 0x00FF'FFFF == sys_tick->reload);
+    expect(that % 48'010 == test_subject.uptime());
+    expect(that % 0 ==
+           hal::bit_extract<interrupt_control_state::pend_systick_set>(
+             scb->icsr));
+  };
+
+  should("systick_counter::~systick_counter()") = [&] {
+    // Setup
+    { systick_counter test_subject(48'000'000.0f); }
+
+    // Verify
+    expect(that % 0 == sys_tick->control);
+  };
+}
+}  // namespace hal::cortex_m
@@ -15,9 +15,12 @@
 #include <libhal-armcortex/systick_timer.hpp>
 
 #include <libhal-armcortex/interrupt.hpp>
+#include <libhal-util/bit.hpp>
+#include <libhal-util/enum.hpp>
 #include <libhal/units.hpp>
 
 #include "helper.hpp"
+#include "system_controller_reg.hpp"
 #include "systick_timer_reg.hpp"
 
 #include <boost/ut.hpp>
@@ -54,8 +57,114 @@ void systick_timer_test()
 
   should("systick_timer::schedule()") = [&] {
     // Setup
+    int calls = 0;
+    auto const isr = [] { get_vector_table()[hal::value(irq::systick)](); };
+
+    // Exercise
+    test_subject.schedule([&calls]() { calls++; }, 10ms);
+
+    // Verify
+    expect(that % 9'999 == sys_tick->reload);
+    expect(test_subject.is_running());
+    expect(that % 1 ==
+           hal::bit_extract<systick_control_register::clock_source>(
+             sys_tick->control));
+
     // Exercise
+    isr();
+
+    // Verify: the callback is called once and the timer stops
+    expect(that % 1 == calls);
+    expect(not test_subject.is_running());
+  };
+
+  should("systick_timer::schedule() beyond 24-bits") = [&] {
+    // Setup
+    int calls = 0;
+    auto const isr = [] { get_vector_table()[hal::value(irq::systick)](); };
+
+    // Exercise: 60M cycles is split into 4 periods of 15M cycles
+    test_subject.schedule([&calls]() { calls++; }, 60s);
+
     // Verify
+    expect(that % 14'999'999 == sys_tick->reload);
+
+    // Exercise
+    isr();
+    isr();
+    isr();
+
+    // Verify
+    expect(that % 0 == calls);
+    expect(test_subject.is_running());
+
+    // Exercise
+    isr();
+
+    // Verify
+    expect(that % 1 == calls);
+    expect(not test_subject.is_running());
+  };
+
+  should("systick_timer::schedule() uses the external clock") = [&] {
+    // Setup
+    int calls = 0;
+    auto const isr = [] { get_vector_table()[hal::value(irq::systick)](); };
+    test_subject.register_external_clock_frequency(125.0_kHz);
+
+    // Exercise: 7.5M external cycles fit within a single period
+    test_subject.schedule([&calls]() { calls++; }, 60s);
+
+    // Verify
+    expect(that % 7'499'999 == sys_tick->reload);
+    expect(that % 0 ==
+           hal::bit_extract<systick_control_register::clock_source>(
+             sys_tick->control));
+    isr();
+    expect(that % 1 == calls);
+
+    // Exercise: short delays keep the resolution of the processor clock
+    test_subject.schedule([&calls]() { calls++; }, 1ms);
+
+    // Verify
+    expect(that % 999 == sys_tick->reload);
+    expect(that % 1 ==
+           hal::bit_extract<systick_control_register::clock_source>(
+             sys_tick->control));
+
+    // Cleanup
+    test_subject.cancel();
+    test_subject.register_external_clock_frequency(0.0_Hz);
+  };
+
+  should("systick_timer::cancel() with the interrupt pending") = [&] {
+    // Setup
+    int calls = 0;
+    auto const isr = [] { get_vector_table()[hal::value(irq::systick)](); };
+    test_subject.schedule([&calls]() { calls++; }, 10ms);
+
+    // Exercise: the interrupt was pending when the timer was cancelled
+    test_subject.cancel();
+    isr();
+
+    // Verify
+    expect(that % 0 == calls);
+    expect(not test_subject.is_running());
+  };
+
+  should("systick_timer::schedule() with the interrupt pending") = [&] {
+    // Setup: the previous event's last period ended with interrupts masked
+    scb->icsr = 1 << 26;
+
+    // Exercise
+    test_subject.schedule([]() {}, 10ms);
+
+    // Verify: the stale interrupt is cleared
+    expect(that % (1 << 25) == scb->icsr);
+    expect(test_subject.is_running());
+
+    // Cleanup
+    test_subject.cancel();
   };
 
   should("systick_timer::~systick_timer()") = [&] {
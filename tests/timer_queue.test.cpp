@@ -0,0 +1,255 @@
+// Copyright 2024 Khalil Estell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <libhal-armcortex/timer_queue.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+namespace hal::cortex_m {
+namespace {
+class fake_clock : public hal::steady_clock
+{
+public:
+  std::uint64_t m_now = 0;
+
+private:
+  hal::hertz driver_frequency() override
+  {
+    return 1'000'000.0f;
+  }
+
+  std::uint64_t driver_uptime() override
+  {
+    return m_now;
+  }
+};
+
+class fake_timer : public hal::timer
+{
+public:
+  hal::callback<void(void)> m_callback;
+  hal::time_duration m_delay{};
+  bool m_running = false;
+
+private:
+  bool driver_is_running() override
+  {
+    return m_running;
+  }
+
+  void driver_cancel() override
+  {
+    m_running = false;
+  }
+
+  void driver_schedule(hal::callback<void(void)> p_callback,
+                       hal::time_duration p_delay) override
+  {
+    m_callback = p_callback;
+    m_delay = p_delay;
+    m_running = true;
+  }
+};
+}  // namespace
+
+void timer_queue_test()
+{
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+
+  "timer_queue::schedule() programs the nearest deadline"_test = []() {
+    // Setup
+    fake_clock clock;
+    fake_timer timer;
+    std::array<timer_event*, 4> storage{};
+    timer_queue test_subject(timer, clock, storage, 1s);
+    std::vector<int> order;
+    timer_event event1([&order]() { order.push_back(1); });
+    timer_event event2([&order]() { order.push_back(2); });
+    timer_event event3([&order]() { order.push_back(3); });
+
+    // Exercise
+    test_subject.schedule(event1, 300us);
+    test_subject.schedule(event2, 100us);
+    test_subject.schedule(event3, 200us);
+
+    // Verify
+    expect(that % 3 == test_subject.size());
+    expect(event1.scheduled() and event2.scheduled() and event3.scheduled());
+    expect(timer.m_running);
+    expect(that % 100 ==
+           std::chrono::duration_cast<std::chrono::microseconds>(timer.m_delay)
+             .count());
+
+    // Exercise: every event expired by the time the interrupt fires
+    clock.m_now = 250;
+    timer.m_callback();
+
+    // Verify: expired events run in deadline order within a single interrupt
+    expect(that % 2 == order.size());
+    expect(that % 2 == order[0]);
+    expect(that % 3 == order[1]);
+    expect(not event2.scheduled());
+    expect(that % 1 == test_subject.size());
+    expect(that % 50 ==
+           std::chrono::duration_cast<std::chrono::microseconds>(timer.m_delay)
+             .count());
+
+    // Exercise
+    clock.m_now = 300;
+    timer.m_callback();
+
+    // Verify
+    expect(that % 3 == order.size());
+    expect(that % 1 == order[2]);
+    expect(that % 0 == test_subject.size());
+    expect(not timer.m_running);
+  };
+
+  "timer_queue::cancel()"_test = []() {
+    // Setup
+    fake_clock clock;
+    fake_timer timer;
+    std::array<timer_event*, 8> storage{};
+    timer_queue test_subject(timer, clock, storage, 1s);
+    int calls = 0;
+    std::array<timer_event, 6> events{
+      timer_event([&calls]() { calls += 1; }),
+      timer_event([&calls]() { calls += 10; }),
+      timer_event([&calls]() { calls += 100; }),
+      timer_event([&calls]() { calls += 1000; }),
+      timer_event([&calls]() { calls += 10000; }),
+      timer_event([&calls]() { calls += 100000; }),
+    };
+    for (std::size_t i = 0; i < events.size(); i++) {
+      test_subject.schedule(events[i], std::chrono::microseconds(10 * (i + 1)));
+    }
+
+    // Exercise
+    test_subject.cancel(events[0]);
+    test_subject.cancel(events[3]);
+    test_subject.cancel(events[3]);
+
+    // Verify
+    expect(that % 4 == test_subject.size());
+    expect(not events[0].scheduled());
+    expect(that % 20 ==
+           std::chrono::duration_cast<std::chrono::microseconds>(timer.m_delay)
+             .count());
+
+    // Exercise
+    clock.m_now = 1000;
+    timer.m_callback();
+
+    // Verify
+    expect(that % 110110 == calls);
+    expect(not timer.m_running);
+  };
+
+  "timer_queue::schedule() when full"_test = []() {
+    // Setup
+    fake_clock clock;
+    fake_timer timer;
+    std::array<timer_event*, 1> storage{};
+    timer_queue test_subject(timer, clock, storage, 1s);
+    timer_event event1([]() {});
+    timer_event event2([]() {});
+    test_subject.schedule(event1, 10us);
+
+    // Exercise & Verify
+    expect(throws([&]() { test_subject.schedule(event2, 10us); }));
+    // Rescheduling does not need more space
+    test_subject.schedule(event1, 20us);
+    expect(that % 1 == test_subject.size());
+  };
+
+  "timer_queue::time_until_next()"_test = []() {
+    // Setup
+    fake_clock clock;
+    fake_timer timer;
+    std::array<timer_event*, 2> storage{};
+    timer_queue test_subject(timer, clock, storage, 1s);
+    timer_event event1([]() {});
+    timer_event event2([]() {});
+
+    // Exercise & Verify
+    expect(hal::time_duration::max() == test_subject.time_until_next());
+
+    test_subject.schedule(event1, 300us);
+    test_subject.schedule(event2, 100us);
+    clock.m_now = 40;
+    expect(hal::time_duration(60us) == test_subject.time_until_next());
+
+    clock.m_now = 150;
+    expect(hal::time_duration(0) == test_subject.time_until_next());
+  };
+
+  "timer_queue::schedule() with the largest delay"_test = []() {
+    // Setup
+    fake_clock clock;
+    fake_timer timer;
+    std::array<timer_event*, 1> storage{};
+    timer_queue test_subject(timer, clock, storage, 1s);
+    timer_event event([]() {});
+
+    // Exercise
+    test_subject.schedule(event, hal::time_duration::max());
+
+    // Verify: the timer is programmed with the maximum delay and the deadline
+    // is far in the future rather than overflowed
+    expect(hal::time_duration(1s) == timer.m_delay);
+    expect(test_subject.time_until_next() > hal::time_duration(100'000h));
+  };
+
+  "timer_queue periodic events & long delays"_test = []() {
+    // Setup
+    fake_clock clock;
+    fake_timer timer;
+    std::array<timer_event*, 2> storage{};
+    timer_queue test_subject(timer, clock, storage, 1ms);
+    int ticks = 0;
+    timer_event* self = nullptr;
+    timer_event periodic([&]() {
+      ticks++;
+      test_subject.schedule(*self, 5ms);
+    });
+    self = &periodic;
+
+    // Exercise
+    test_subject.schedule(periodic, 5ms);
+
+    // Verify: delays longer than the timer supports are split up
+    expect(that % 1 ==
+           std::chrono::duration_cast<std::chrono::milliseconds>(timer.m_delay)
+             .count());
+    clock.m_now = 1000;
+    timer.m_callback();
+    expect(that % 0 == ticks);
+
+    // Exercise
+    clock.m_now = 5000;
+    timer.m_callback();
+
+    // Verify
+    expect(that % 1 == ticks);
+    expect(periodic.scheduled());
+    expect(that % 1 == test_subject.size());
+  };
+}
+}  // namespace hal::cortex_m